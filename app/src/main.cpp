@@ -4,24 +4,26 @@
 #include <QElapsedTimer>
 #include <string>
 #include <algorithm>
-#include <sstream>
 #include <format>
 #include "ui_main_window.h"
 #include "ui_info_widget.h"
 #include "table.h"
 #include "calculator.h"
 
+// Long polynomials are shown in the table by their beginning only
+const size_t TablePreviewLength = 4096;
+
 void tableWidgetUpdate(QTableWidget* pTableWidget, Aggregator* pAggregator)
 {
-    std::vector<std::pair< std::string, Polynomial>> records = pAggregator->getPolynomials();
+    std::vector<std::pair< std::string, PolynomialHandle>> records = pAggregator->getPolynomials();
     pTableWidget->setRowCount(0);
 
+    std::string polyString;
     for (int i = 0; i < records.size(); i++)
     {
-        std::pair< std::string, Polynomial> record = records[i];
-        std::ostringstream os;
-        os << record.second;
-        std::string polyString = os.str();
+        const std::pair< std::string, PolynomialHandle>& record = records[i];
+        polyString.clear();
+        record.second->appendTo(polyString, TablePreviewLength);
 
         pTableWidget->insertRow(pTableWidget->rowCount());
         QTableWidgetItem* twi = new QTableWidgetItem(QString::fromStdString(record.first));
@@ -36,7 +38,7 @@ void tableWidgetUpdate(QTableWidget* pTableWidget, Aggregator* pAggregator)
 
 void calculateAction(Aggregator* pAggregator, QTextEdit* pOutputField, std::string polyName, double w = 0.0, double x = 0.0, double y = 0.0, double z = 0.0)
 {
-    double result = (pAggregator->findPolynomial(polyName).value()).evaluate(w, x, y, z);
+    double result = pAggregator->findPolynomial(polyName)->evaluate(w, x, y, z);
 
     std::string outputLine = polyName + std::format("({}, {}, {}, {})", w, x, y, z) + " = " + std::to_string(result);
 
@@ -79,12 +81,8 @@ bool inputHandle(std::string inp, Aggregator* pAggregator, QLineEdit* pInputErro
     {
         Polynomial resPol = std::get<Polynomial>(result);
 
-        std::ostringstream os;
-        os << resPol;
         std::string str;
-        str = os.str();
-        os.str("");
-        os.clear();
+        resPol.appendTo(str);
 
         pOutputField->setHtml(QString::fromStdString(str) + '\n' + pOutputField->toHtml());
         tableWidgetUpdate(pTableWidget, pAggregator);
@@ -118,7 +116,7 @@ void clearAction(QTableWidget* pTableWidget, Aggregator* pAggregator)
 {
     auto records = pAggregator->getPolynomials();
 
-    for (auto record : records)
+    for (const auto& record : records)
     {
         pAggregator->delPolynomial(record.first);
     }
@@ -148,6 +146,9 @@ void changeTable(QTableWidget* pTableWidget, Aggregator* pAggregator, std::strin
     } else if (text == "Separate chaining hash table")
     {
         code = "seha";
+    } else if (text == "Swiss hash table")
+    {
+        code = "swis";
     } else
     {
         throw "Something went wrong during table changing";
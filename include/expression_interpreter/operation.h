@@ -9,7 +9,8 @@ namespace Intr {
         ASSIGN,
         ADD, SUBTRACT, MULT, POWER, UMINUS,
         CALC, DERX, DERY, DERZ, DERW,
-        INTX, INTY, INTZ, INTW
+        INTX, INTY, INTZ, INTW,
+        TRUNCMUL, TRUNCPOW
     };
 
     // Код операции/полином/идентификатор/число
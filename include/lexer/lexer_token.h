@@ -11,6 +11,7 @@ namespace Lexer {
         PLUS, MINUS, MULT, CARET, ASSIGN, COMMA,
         CALC, DERX, DERY, DERZ, DERW,
         INTX, INTY, INTZ, INTW,
+        TRUNCMUL, TRUNCPOW,
         INVALID,
         ENDOFFILE
     };
@@ -1,8 +1,12 @@
 #pragma once
 
+#include "memory_scope.h"
 #include <initializer_list>
+#include <memory_resource>
+#include <new>
 #include <stdexcept>
 
+// Звенья выделяются из ресурса памяти, заданного при создании списка (по умолчанию - currentMemoryResource())
 template<typename T>
 class LinkedList
 {
@@ -16,6 +20,26 @@ private:
     Node* mFirst;
     Node* mLast;
     size_t mSize;
+    std::pmr::memory_resource* mpResource;
+
+    Node* createNode(const T& data, Node* next)
+    {
+        void* memory = mpResource->allocate(sizeof(Node), alignof(Node));
+        try
+        {
+            return new (memory) Node{ data, next };
+        } catch (...)
+        {
+            mpResource->deallocate(memory, sizeof(Node), alignof(Node));
+            throw;
+        }
+    }
+
+    void destroyNode(Node* node) noexcept
+    {
+        node->~Node();
+        mpResource->deallocate(node, sizeof(Node), alignof(Node));
+    }
 
 public:
     struct Iterator
@@ -70,8 +94,10 @@ public:
         friend class LinkedList;
     };
 
-    LinkedList() : mSize(0), mFirst(nullptr), mLast(nullptr) {}
-    LinkedList(const std::initializer_list<T>& elems) : mSize(0), mFirst(nullptr), mLast(nullptr)
+    LinkedList() : LinkedList(currentMemoryResource()) {}
+    explicit LinkedList(std::pmr::memory_resource* resource) : mSize(0), mFirst(nullptr), mLast(nullptr), mpResource(resource) {}
+    LinkedList(const std::initializer_list<T>& elems, std::pmr::memory_resource* resource = currentMemoryResource()) :
+        mSize(0), mFirst(nullptr), mLast(nullptr), mpResource(resource)
     {
         for (const auto& elem : elems)
         {
@@ -79,7 +105,8 @@ public:
         }
     }
 
-    LinkedList(const LinkedList& other) : mSize(0), mFirst(nullptr), mLast(nullptr)
+    LinkedList(const LinkedList& other, std::pmr::memory_resource* resource = currentMemoryResource()) :
+        mSize(0), mFirst(nullptr), mLast(nullptr), mpResource(resource)
     {
         for (const auto& elem : other)
         {
@@ -87,7 +114,7 @@ public:
         }
     }
 
-    LinkedList(LinkedList&& other) noexcept : mSize(other.mSize), mFirst(other.mFirst), mLast(other.mLast)
+    LinkedList(LinkedList&& other) noexcept : mSize(other.mSize), mFirst(other.mFirst), mLast(other.mLast), mpResource(other.mpResource)
     {
         other.mSize = 0;
         other.mFirst = nullptr;
@@ -111,6 +138,8 @@ public:
         {
             pushBack(elem);
         }
+
+        return *this;
     }
 
     LinkedList& operator=(LinkedList&& other)
@@ -120,6 +149,14 @@ public:
             return *this;
         }
 
+        // звенья other нельзя освободить через свой ресурс - копируем
+        if (mpResource != other.mpResource && *mpResource != *other.mpResource)
+        {
+            *this = other;
+            other.clear();
+            return *this;
+        }
+
         clear();
         mFirst = other.mFirst;
         mLast = other.mLast;
@@ -127,14 +164,17 @@ public:
         other.mFirst = nullptr;
         other.mLast = nullptr;
         other.mSize = 0;
+
+        return *this;
     }
 
     size_t size() const noexcept { return mSize; }
+    std::pmr::memory_resource* resource() const noexcept { return mpResource; }
     bool empty() const noexcept { return size() == 0; }
 
     void pushFront(const T& elem)
     {
-        Node* nw = new Node{ elem, mFirst };
+        Node* nw = createNode(elem, mFirst);
         mFirst = nw;
         if (mLast == nullptr)
         {
@@ -146,7 +186,7 @@ public:
 
     void pushBack(const T& elem)
     {
-        Node* nw = new Node{ elem, nullptr };
+        Node* nw = createNode(elem, nullptr);
         if (mLast != nullptr)
         {
             mLast->next = nw;
@@ -169,14 +209,14 @@ public:
 
         if (mFirst == mLast)
         {
-            delete mFirst;
+            destroyNode(mFirst);
             mFirst = nullptr;
             mLast = nullptr;
         } else
         {
             Node* tmp = mFirst;
             mFirst = mFirst->next;
-            delete tmp;
+            destroyNode(tmp);
         }
 
         --mSize;
@@ -191,7 +231,7 @@ public:
 
         if (mLast == mFirst)
         {
-            delete mLast;
+            destroyNode(mLast);
             mFirst = nullptr;
             mLast = nullptr;
         } else
@@ -201,7 +241,7 @@ public:
             cur->next = nullptr;
             Node* tmp = mLast;
             mLast = cur;
-            delete tmp;
+            destroyNode(tmp);
         }
 
         --mSize;
@@ -254,7 +294,7 @@ public:
             return Iterator(mFirst);
         }
 
-        Node* nw = new Node{ data, pos.mpNext };
+        Node* nw = createNode(data, pos.mpNext);
         pos.mpCurrent->next = nw;
 
         ++mSize;
@@ -282,7 +322,7 @@ public:
         }
 
         pos.mpCurrent->next = pos.mpNext->next;
-        delete pos.mpNext;
+        destroyNode(pos.mpNext);
         --mSize;
     }
 
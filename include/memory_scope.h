@@ -0,0 +1,38 @@
+#pragma once
+
+#include <memory_resource>
+
+// Ресурс памяти, из которого выделяют память полиномы (SmallVector) и контейнеры, созданные в этом
+// потоке без явного ресурса. По умолчанию - std::pmr::get_default_resource() (глобальная куча)
+inline thread_local std::pmr::memory_resource* sCurrentMemoryResource = nullptr;
+
+inline std::pmr::memory_resource* currentMemoryResource() noexcept
+{
+    return sCurrentMemoryResource != nullptr ? sCurrentMemoryResource : std::pmr::get_default_resource();
+}
+
+// Пока объект существует, currentMemoryResource() в этом потоке возвращает resource.
+// Например, все промежуточные полиномы одного вычисления можно разместить в
+// std::pmr::monotonic_buffer_resource и освободить одним разом. Объекты, созданные внутри области,
+// не должны пережить resource: то, что хранится дольше, копируется под ресурсом previous()
+class MemoryResourceScope
+{
+public:
+    explicit MemoryResourceScope(std::pmr::memory_resource* resource) noexcept : mpPrevious(currentMemoryResource())
+    {
+        sCurrentMemoryResource = resource;
+    }
+
+    MemoryResourceScope(const MemoryResourceScope&) = delete;
+    MemoryResourceScope& operator=(const MemoryResourceScope&) = delete;
+
+    ~MemoryResourceScope()
+    {
+        sCurrentMemoryResource = mpPrevious;
+    }
+
+    std::pmr::memory_resource* previous() const noexcept { return mpPrevious; }
+
+private:
+    std::pmr::memory_resource* mpPrevious;
+};
@@ -0,0 +1,199 @@
+#pragma once
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Простые числа, близкие к 2^62, для точной арифметики коэффициентов по модулю
+const uint64_t ModularPrime1 = 4611686018427387847; // 2^62 - 57
+const uint64_t ModularPrime2 = 4611686018427387817; // 2^62 - 87
+const uint64_t ModularPrime3 = 4611686018427387787; // 2^62 - 117
+
+// Арифметика по нечетному модулю m < 2^62 в форме Монтгомери (R = 2^64): число x хранится как x * R mod m,
+// и произведение приводится по модулю двумя умножениями без деления
+class Montgomery
+{
+public:
+    constexpr explicit Montgomery(uint64_t modulus) noexcept :
+        mModulus(modulus), mInverse(inverseModR(modulus)), mOne((0 - modulus) % modulus), mR2(doubleMod(mOne, modulus, 64))
+    {
+    }
+
+    constexpr uint64_t modulus() const noexcept { return mModulus; }
+    constexpr uint64_t one() const noexcept { return mOne; } // единица в форме Монтгомери
+
+    static uint64_t mulHigh(uint64_t a, uint64_t b) noexcept
+    {
+#if defined(_MSC_VER)
+        return __umulh(a, b);
+#else
+        return static_cast<uint64_t>((static_cast<unsigned __int128>(a) * b) >> 64);
+#endif
+    }
+
+    uint64_t multiply(uint64_t a, uint64_t b) const noexcept
+    {
+        return reduce(mulHigh(a, b), a * b);
+    }
+
+    uint64_t add(uint64_t a, uint64_t b) const noexcept
+    {
+        const uint64_t sum = a + b;
+        return sum >= mModulus ? sum - mModulus : sum;
+    }
+
+    uint64_t subtract(uint64_t a, uint64_t b) const noexcept
+    {
+        return a >= b ? a - b : a + mModulus - b;
+    }
+
+    uint64_t toMontgomery(uint64_t x) const noexcept
+    {
+        return multiply(x % mModulus, mR2);
+    }
+
+    uint64_t fromMontgomery(uint64_t x) const noexcept
+    {
+        return reduce(0, x);
+    }
+
+    // base и результат - в форме Монтгомери
+    uint64_t pow(uint64_t base, uint64_t exponent) const noexcept
+    {
+        uint64_t result = mOne;
+        for (; exponent != 0; exponent >>= 1)
+        {
+            if (exponent & 1) result = multiply(result, base);
+            base = multiply(base, base);
+        }
+        return result;
+    }
+
+private:
+    uint64_t mModulus;
+    uint64_t mInverse; // mModulus^-1 mod 2^64
+    uint64_t mOne;     // R mod mModulus
+    uint64_t mR2;      // R^2 mod mModulus
+
+    // (hi * 2^64 + lo) * R^-1 mod m для hi < m: q * m совпадает с lo в младшем слове,
+    // поэтому разность делится на 2^64 и равна hi - старшее слово q * m
+    uint64_t reduce(uint64_t hi, uint64_t lo) const noexcept
+    {
+        const uint64_t q = lo * mInverse;
+        const uint64_t h = mulHigh(q, mModulus);
+        return hi >= h ? hi - h : hi + mModulus - h;
+    }
+
+    static constexpr uint64_t inverseModR(uint64_t m) noexcept
+    {
+        // метод Ньютона: каждая итерация удваивает число верных младших битов
+        uint64_t inverse = m;
+        for (int i = 0; i < 5; ++i)
+        {
+            inverse *= 2 - m * inverse;
+        }
+        return inverse;
+    }
+
+    static constexpr uint64_t doubleMod(uint64_t x, uint64_t m, int times) noexcept
+    {
+        for (int i = 0; i < times; ++i)
+        {
+            x = x * 2 >= m ? x * 2 - m : x * 2;
+        }
+        return x;
+    }
+};
+
+// Вычет по простому модулю Modulus < 2^62. Используется как тип коэффициентов полинома
+// (BasicPolynomial<NVars, Bits, ModInt<Modulus>>) для точных вычислений с целыми коэффициентами
+template <uint64_t Modulus>
+class ModInt
+{
+    static_assert(Modulus % 2 == 1 && Modulus > 2 && Modulus < (uint64_t(1) << 62), "Modulus must be an odd prime below 2^62");
+
+public:
+    static constexpr uint64_t modulus() noexcept { return Modulus; }
+
+    constexpr ModInt() noexcept : mValue(0) {}
+
+    template <std::integral T>
+    ModInt(T value) noexcept
+    {
+        if constexpr (std::is_signed_v<T>)
+        {
+            const uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : static_cast<uint64_t>(value);
+            mValue = sContext.toMontgomery(magnitude);
+            if (value < 0) mValue = sContext.subtract(0, mValue);
+        } else
+        {
+            mValue = sContext.toMontgomery(static_cast<uint64_t>(value));
+        }
+    }
+
+    // Представитель из [0, Modulus)
+    uint64_t value() const noexcept { return sContext.fromMontgomery(mValue); }
+
+    // Представитель из симметричного диапазона (-Modulus / 2, Modulus / 2]
+    int64_t signedValue() const noexcept
+    {
+        const uint64_t v = value();
+        return v > Modulus / 2 ? -static_cast<int64_t>(Modulus - v) : static_cast<int64_t>(v);
+    }
+
+    ModInt pow(uint64_t exponent) const noexcept { return fromRaw(sContext.pow(mValue, exponent)); }
+
+    // Обратный элемент по малой теореме Ферма (для ненулевого вычета)
+    ModInt inverse() const noexcept { return pow(Modulus - 2); }
+
+    ModInt& operator+=(ModInt other) noexcept { mValue = sContext.add(mValue, other.mValue); return *this; }
+    ModInt& operator-=(ModInt other) noexcept { mValue = sContext.subtract(mValue, other.mValue); return *this; }
+    ModInt& operator*=(ModInt other) noexcept { mValue = sContext.multiply(mValue, other.mValue); return *this; }
+    ModInt& operator/=(ModInt other) noexcept { return *this *= other.inverse(); }
+
+    friend ModInt operator+(ModInt a, ModInt b) noexcept { return a += b; }
+    friend ModInt operator-(ModInt a, ModInt b) noexcept { return a -= b; }
+    friend ModInt operator*(ModInt a, ModInt b) noexcept { return a *= b; }
+    friend ModInt operator/(ModInt a, ModInt b) noexcept { return a /= b; }
+    ModInt operator-() const noexcept { return fromRaw(sContext.subtract(0, mValue)); }
+
+    friend bool operator==(ModInt a, ModInt b) noexcept { return a.mValue == b.mValue; }
+    friend bool operator!=(ModInt a, ModInt b) noexcept { return a.mValue != b.mValue; }
+
+private:
+    static constexpr Montgomery sContext{ Modulus };
+
+    uint64_t mValue; // в форме Монтгомери
+
+    static ModInt fromRaw(uint64_t raw) noexcept
+    {
+        ModInt result;
+        result.mValue = raw;
+        return result;
+    }
+};
+
+// Восстановление целого числа по остаткам по различным нечетным простым модулям (алгоритм Гарнера).
+// Число записывается в смешанной системе счисления x = d0 + m0 * (d1 + m1 * (d2 + ...)) с цифрами
+// |di| <= (mi - 1) / 2; такая запись однозначно задает любое x из диапазона |x| < M / 2, M = m0 * m1 * ...
+class CrtReconstructor
+{
+public:
+    explicit CrtReconstructor(const std::vector<uint64_t>& moduli);
+
+    size_t size() const noexcept { return mContexts.size(); }
+
+    /// @brief Восстановить число по остаткам residues[i] по модулю moduli[i]
+    /// @return x из диапазона |x| < M / 2, округленное до double (точное, если |x| < 2^53)
+    double reconstruct(const uint64_t* residues) const;
+
+private:
+    std::vector<Montgomery> mContexts;
+    // Для модуля i: mj mod mi (j < i) и (m0 * ... * m(i-1))^-1 mod mi в форме Монтгомери
+    std::vector<std::vector<uint64_t>> mLowerModuli;
+    std::vector<uint64_t> mPrefixInverses;
+};
@@ -0,0 +1,18 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Ntt {
+    /// @brief Максимальная длина свертки (ограничена порядком корней из единицы по используемым модулям)
+    const size_t MaxConvolutionLength = size_t(1) << 25;
+
+    /// @brief Точная свертка целочисленных последовательностей с помощью теоретико-числового преобразования
+    /// по двум простым модулям и восстановления результата по китайской теореме об остатках
+    /// @param a первая последовательность
+    /// @param b вторая последовательность
+    /// @return последовательность длины a.size() + b.size() - 1. Результат точен, если модуль
+    /// каждого элемента свертки меньше 2^55. Если a и b - один и тот же объект, вычисляется квадрат
+    /// с одним прямым преобразованием вместо двух
+    std::vector<int64_t> convolve(const std::vector<int64_t>& a, const std::vector<int64_t>& b);
+}
\ No newline at end of file
@@ -1,78 +1,471 @@
 #pragma once
-#include "linked_list.h"
+#include "modular.h"
+#include "small_vector.h"
 #include "syntax_error.h"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <charconv>
 #include <cstdint>
+#include <functional>
+#include <memory>
+#include <stdexcept>
 #include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
 #include <variant>
+#include <vector>
 #include <iostream>
 
-class Polynomial
+// Способ умножения полиномов, выбираемый моделью стоимости (BasicPolynomial::multiplicationStrategy)
+enum class MultiplicationStrategy
 {
+    Monomial, // один из сомножителей - одночлен: сдвиг степеней
+    Heap,     // слияние произведений строк кучей
+    Hash,     // накопление произведений в хеш-таблице по степени и одна сортировка
+    Dense,    // свертка плотных представлений через NTT
+    Parallel  // слияние кучей по отрезкам степеней в нескольких потоках
+};
+
+inline const char* multiplicationStrategyName(MultiplicationStrategy strategy) noexcept
+{
+    switch (strategy)
+    {
+    case MultiplicationStrategy::Monomial: return "monomial";
+    case MultiplicationStrategy::Heap: return "heap";
+    case MultiplicationStrategy::Hash: return "hash";
+    case MultiplicationStrategy::Dense: return "dense";
+    case MultiplicationStrategy::Parallel: return "parallel";
+    }
+    return "unknown";
+}
+
+// Полином от NVars переменных с показателями степеней не больше 2^Bits - 1.
+// Показатели всех переменных упакованы в одно 64-битное слово (первая переменная - в старших
+// разрядах), поэтому сравнение степеней мономов - сравнение чисел, а умножение мономов - сложение.
+// Переменные называются последними NVars буквами из "stuvwxyz": при NVars = 4 это w, x, y, z.
+// Коэффициенты имеют тип Coefficient: double или ModInt<p> для точной арифметики по простому модулю p.
+// Определения находятся в polynomial.cpp, где явно инстанцированы конфигурации 4x16 (Polynomial), 8x8 и 2x32
+// с коэффициентами double и 4x16 с коэффициентами по модулям ModularPrime1..3 (ModularPolynomial)
+template <unsigned NVars, unsigned Bits, typename Coefficient = double>
+class BasicPolynomial
+{
+    static_assert(NVars >= 1 && NVars <= 8, "Number of variables must be from 1 to 8");
+    static_assert(Bits >= 1 && Bits <= 32, "Exponent width must be from 1 to 32 bits");
+    static_assert(NVars * Bits <= 64, "Packed exponents must fit in a 64-bit word");
+
+public:
+    static constexpr unsigned VariableCount = NVars;
+    static constexpr uint32_t MaxDegree = static_cast<uint32_t>((uint64_t(1) << Bits) - 1);
+
+    // Имя переменной var (0 - первая)
+    static constexpr char variableName(unsigned var) noexcept { return static_cast<char>('z' - (NVars - 1) + var); }
+
 private:
-    class Monomial
-    {
-    private:
-        double mCoefficient;
-        uint64_t mDegree;
-    public:
-        Monomial() noexcept : mCoefficient(0.0), mDegree(0) {}
-        Monomial(double coefficient, uint32_t w, uint32_t x, uint32_t y, uint32_t z) noexcept : mCoefficient(coefficient),
-            mDegree(((uint64_t)w << 48) | ((uint64_t)x << 32) | ((uint64_t)y << 16) | ((uint64_t)z))
+    template <unsigned, unsigned, typename> friend class BasicPolynomial;
+
+    static constexpr bool IsFloatingPoint = std::is_floating_point_v<Coefficient>;
+
+    // Моном, прочитанный из строки; end - позиция сразу после него
+    struct ParsedMonomial
+    {
+        uint64_t degree;
+        Coefficient coefficient;
+        size_t end;
+    };
+
+    // Мономы хранятся в двух параллельных массивах, отсортированных по убыванию степени.
+    // Полиномы из нескольких мономов (константы, результаты производных небольших полиномов)
+    // умещаются внутри объекта и не требуют выделения памяти
+    static const size_t InlineMonomials = 4;
+    SmallVector<uint64_t, InlineMonomials> mDegrees;
+    SmallVector<Coefficient, InlineMonomials> mCoefficients;
+
+    // Плотная форма: если мономы заполняют большую часть прямоугольной области степеней, mDegrees пуст,
+    // а mCoefficients хранит коэффициенты всех ячеек области (нули - для отсутствующих мономов) по
+    // убыванию упакованной степени. Ячейка с показателями e имеет номер sum((top[v] - e[v]) * stride[v]),
+    // где stride последней переменной равен 1. Форма выбирается по заполнению области (chooseRepresentation)
+    // и не видна снаружи: операции, для которых плотная форма неудобна, работают с разреженной копией
+    struct DenseBox
+    {
+        uint64_t top = 0;            // упакованная степень старшего угла области
+        uint32_t extent[NVars] = {}; // число показателей каждой переменной в области; 0 - разреженная форма
+        size_t terms = 0;            // число ненулевых коэффициентов
+    };
+    DenseBox mBox;
+
+    // Схема Горнера для evaluate строится при первом вычислении. Копия разделяет схему, только если она
+    // уже построена: копирование ничего не выделяет. Любое изменение мономов отвязывает полином от схемы
+    // (invalidateEvaluationPlan)
+    struct EvaluationPlan;
+    mutable std::atomic<std::shared_ptr<EvaluationPlan>> mEvaluationPlan;
+
+    std::shared_ptr<EvaluationPlan> sharedEvaluationPlan() const;
+    void invalidateEvaluationPlan() noexcept { mEvaluationPlan.store(nullptr); }
+
+    using Exponents = std::array<uint32_t, NVars>;
+
+    static constexpr unsigned variableShift(unsigned var) noexcept { return Bits * (NVars - 1 - var); }
+    static constexpr uint64_t packDegree(const Exponents& exponents) noexcept
+    {
+        uint64_t degree = 0;
+        for (unsigned var = 0; var < NVars; ++var)
+        {
+            degree |= static_cast<uint64_t>(exponents[var]) << variableShift(var);
+        }
+        return degree;
+    }
+    // var: 0 - первая переменная (w при NVars = 4), NVars - 1 - последняя (z)
+    static constexpr uint32_t variableDegree(uint64_t degree, unsigned var) noexcept
+    {
+        return static_cast<uint32_t>(degree >> variableShift(var)) & MaxDegree;
+    }
+    static uint64_t variableUnit(unsigned var); // упакованная степень одночлена var^1
+    // Полная степень монома - сумма показателей всех переменных
+    static constexpr uint64_t totalDegree(uint64_t degree) noexcept
+    {
+        uint64_t total = 0;
+        for (unsigned var = 0; var < NVars; ++var)
         {
-            if (w > UINT16_MAX || x > UINT16_MAX || y > UINT16_MAX || z > UINT16_MAX)
+            total += variableDegree(degree, var);
+        }
+        return total;
+    }
+
+    // Разряды, в которые попадает перенос из поля показателя при сложении упакованных степеней:
+    // младшие разряды всех полей, кроме последнего, и разряд над старшим полем, если он есть в слове
+    static constexpr uint64_t CarryBits = []
+    {
+        uint64_t bits = 0;
+        for (unsigned field = 1; field <= NVars && field * Bits < 64; ++field)
+        {
+            bits |= uint64_t(1) << (field * Bits);
+        }
+        return bits;
+    }();
+    // Сложение и вычитание упакованных степеней - одна операция над словом. Перенос в разряд i равен
+    // разряду i слова a ^ b ^ (a + b) (для вычитания - заем в a ^ b ^ (a - b)), поэтому переполнение
+    // любого показателя проверяется одной маской CarryBits без защитных разрядов между полями,
+    // которые сократили бы диапазон степеней. Перенос из старшего поля 64-битного слова теряется,
+    // его выдает сравнение результата с операндом
+    static constexpr bool degreeSumOverflows(uint64_t a, uint64_t b) noexcept
+    {
+        const uint64_t sum = a + b;
+        return ((a ^ b ^ sum) & CarryBits) != 0 || sum < a;
+    }
+    static constexpr bool degreeDifferenceUnderflows(uint64_t a, uint64_t b) noexcept
+    {
+        const uint64_t difference = a - b;
+        return ((a ^ b ^ difference) & CarryBits) != 0 || a < b;
+    }
+
+    struct DegreeBounds
+    {
+        uint32_t min[NVars];
+        uint32_t max[NVars];
+    };
+
+    void pushBack(uint64_t degree, Coefficient coefficient)
+    {
+        mDegrees.push_back(degree);
+        mCoefficients.push_back(coefficient);
+    }
+
+    void reserve(size_t count)
+    {
+        mDegrees.reserve(count);
+        mCoefficients.reserve(count);
+    }
+
+    // Обойти ненулевые мономы по убыванию степени; visit(degree, coefficient) возвращает false,
+    // чтобы прервать обход. Возвращает false, если обход прерван
+    template <typename Visitor>
+    bool forEachTerm(Visitor&& visit) const
+    {
+        if (!isDense())
+        {
+            for (size_t i = 0; i < mDegrees.size(); ++i)
             {
-                throw std::invalid_argument(__FUNCTION__ ": overflow occurred.");
+                if (!visit(mDegrees[i], mCoefficients[i])) return false;
             }
+            return true;
         }
 
-        bool operator==(const Monomial& other) const { return mCoefficient == other.mCoefficient && mDegree == other.mDegree; }
-        bool operator!=(const Monomial& other) const { return !operator==(other); }
+        // номер ячейки - число в смешанной системе счисления с разрядами top[v] - e[v]
+        uint32_t digits[NVars] = {};
+        uint64_t degree = mBox.top;
+        for (size_t index = 0; index < mCoefficients.size(); ++index)
+        {
+            if (mCoefficients[index] != Coefficient() && !visit(degree, mCoefficients[index])) return false;
 
-        double coefficient() const noexcept { return mCoefficient; }
-        void setCoefficient(double coefficient) { mCoefficient = coefficient; }
-        uint64_t degree() const noexcept { return mDegree; }
-        uint16_t w() const noexcept { return static_cast<uint16_t>(mDegree >> 48); }
-        uint16_t x() const noexcept { return static_cast<uint16_t>(mDegree >> 32); }
-        uint16_t y() const noexcept { return static_cast<uint16_t>(mDegree >> 16); }
-        uint16_t z() const noexcept { return static_cast<uint16_t>(mDegree); }
-    };
+            for (unsigned var = NVars; var-- > 0;)
+            {
+                const uint64_t unit = uint64_t(1) << variableShift(var);
+                if (++digits[var] < mBox.extent[var])
+                {
+                    degree -= unit;
+                    break;
+                }
+                degree += unit * (mBox.extent[var] - 1);
+                digits[var] = 0;
+            }
+        }
+        return true;
+    }
 
-    LinkedList<Monomial> mMonomials;
+    BasicPolynomial sparseCopy() const;
+    // p, если он в разреженной форме, иначе его разреженная копия, записанная в storage
+    static const BasicPolynomial& sparseForm(const BasicPolynomial& p, BasicPolynomial& storage);
+    void makeSparse();
+    void makeDense(const DegreeBounds& bounds);
+    void chooseRepresentation(); // перейти в плотную форму, если мономы заполняют область степеней
+    void countTerms() noexcept;
+    static bool addBox(BasicPolynomial& target, const BasicPolynomial& p, Coefficient factor); // target += factor * p, если область p внутри области target
+    static BasicPolynomial mergeDense(const BasicPolynomial& a, const BasicPolynomial& b, Coefficient factor);
+    Coefficient evaluateDense(const std::array<Coefficient, NVars>& point) const;
 
-    static std::variant<Monomial, SyntaxError> parseMonomial(const std::string& str, size_t& offset);
-    static std::variant<Polynomial, SyntaxError> parsePolynomial(const std::string& str);
+    static BasicPolynomial mergeScaled(const BasicPolynomial& a, const BasicPolynomial& b, Coefficient factor); // a + factor * b
+    void mergeScaledInPlace(const BasicPolynomial& other, Coefficient factor); // *this += factor * other
+    void negate() noexcept;
 
-    explicit Polynomial(const std::string& strRepr) {}
+    DegreeBounds degreeBounds() const;
+    std::pair<uint64_t, uint64_t> totalDegreeRange() const; // наименьшая и наибольшая полные степени мономов
+    static void checkMultiplicationOverflow(const DegreeBounds& a, const DegreeBounds& b);
+    static double denseProductCost(const DegreeBounds& a, const DegreeBounds& b); // -1, если плотное произведение слишком длинное
+    static double productLength(const DegreeBounds& a, const DegreeBounds& b); // длина плотного представления произведения
+    // Плотное умножение через NTT точно только для целых коэффициентов double
+    static bool isDenseProductProfitable(const BasicPolynomial& a, const DegreeBounds& ba, const BasicPolynomial& b, const DegreeBounds& bb);
+    static MultiplicationStrategy chooseMultiplication(const BasicPolynomial& a, const DegreeBounds& ba, const BasicPolynomial& b, const DegreeBounds& bb);
+    static BasicPolynomial multiplyHeap(const BasicPolynomial& a, const BasicPolynomial& b);
+    static BasicPolynomial multiplyHash(const BasicPolynomial& a, const BasicPolynomial& b, size_t expectedSize); // a == b - квадрат
+    static BasicPolynomial multiplyTruncated(const BasicPolynomial& a, const BasicPolynomial& b, uint64_t maxTotalDegree); // a == b - квадрат
+    static BasicPolynomial multiplyByMonomial(const BasicPolynomial& p, uint64_t degree, Coefficient coefficient);
+    // Умножение, квадрат и усеченное произведение разреженных полиномов; результат - в разреженной форме
+    static BasicPolynomial multiplySparse(const BasicPolynomial& a, const BasicPolynomial& b);
+    static BasicPolynomial squareSparse(const BasicPolynomial& a);
+    static BasicPolynomial mulTruncatedSparse(const BasicPolynomial& a, const BasicPolynomial& b, uint64_t maxTotalDegree); // a == b - квадрат
+    static BasicPolynomial squareHeap(const BasicPolynomial& a);
+    static BasicPolynomial multiplyDense(const BasicPolynomial& a, const DegreeBounds& ba, const BasicPolynomial& b, const DegreeBounds& bb)
+        requires IsFloatingPoint;
+    static BasicPolynomial multiplyHeapRange(const BasicPolynomial& a, const BasicPolynomial& b, uint64_t lowDegree, uint64_t highDegree);
+    static BasicPolynomial multiplyParallel(const BasicPolynomial& a, const BasicPolynomial& b, unsigned threadCount);
+
+    static std::variant<ParsedMonomial, SyntaxError> parseMonomial(std::string_view str, size_t& offset);
+    static std::variant<BasicPolynomial, SyntaxError> parsePolynomial(std::string_view str);
+
+    static constexpr size_t decimalDigits(uint64_t value) noexcept
+    {
+        size_t digits = 1;
+        for (; value >= 10; value /= 10) ++digits;
+        return digits;
+    }
+    // Наибольшая длина записи коэффициента ("-1.23457e-308" или целое из 19 цифр со знаком)
+    // и одного монома: знак, коэффициент и NVars множителей вида "*w^65535"
+    static const size_t MaxCoefficientChars = IsFloatingPoint ? 13 : 20;
+    static const size_t MaxMonomialChars = 1 + MaxCoefficientChars + NVars * (3 + decimalDigits(MaxDegree));
+    static size_t formatMonomial(char* out, uint64_t degree, Coefficient coefficient, bool leading) noexcept;
+    size_t estimateTextLength(size_t limit) const noexcept;
+
+    explicit BasicPolynomial(const std::string& strRepr) {}
 public:
-    Polynomial() {}
-    Polynomial(double num);
+    BasicPolynomial() {}
+    BasicPolynomial(Coefficient num);
+    BasicPolynomial(const BasicPolynomial& other);
+    BasicPolynomial(BasicPolynomial&& other) noexcept;
+    BasicPolynomial& operator=(const BasicPolynomial& other);
+    BasicPolynomial& operator=(BasicPolynomial&& other); // копирует мономы, если у полиномов разные ресурсы памяти
 
-    static std::variant<Polynomial, SyntaxError> fromString(const std::string& str)
+    static std::variant<BasicPolynomial, SyntaxError> fromString(std::string_view str)
     {
         return parsePolynomial(str);
     }
 
-    bool operator==(const Polynomial& other) const;
-    bool operator!=(const Polynomial& other) const;
-
-    Polynomial operator+(const Polynomial& other) const;
-    Polynomial& operator+=(const Polynomial& other);
-    Polynomial operator-() const;
-    Polynomial operator-(const Polynomial& other) const;
-    Polynomial& operator-=(const Polynomial& other);
-    Polynomial operator*(const Polynomial& other) const;
-    Polynomial operator*(double coefficient) const;
-    friend Polynomial operator*(double coefficient, const Polynomial& p);
-    Polynomial& operator*=(double coefficient);
-    friend std::ostream& operator<<(std::ostream& ostr, const Polynomial& p);
-
-    double evaluate(double w, double x, double y, double z) const;
-    Polynomial derivativeW() const;
-    Polynomial derivativeX() const;
-    Polynomial derivativeY() const;
-    Polynomial derivativeZ() const;
-    Polynomial integralX() const;
-    Polynomial integralY() const;
-    Polynomial integralZ() const;
-    Polynomial integralW() const;
-};
\ No newline at end of file
+    size_t size() const noexcept { return isDense() ? mBox.terms : mDegrees.size(); } // number of monomials
+
+    /// @brief Узнать, хранится ли полином в плотной форме (коэффициенты всех ячеек области степеней)
+    bool isDense() const noexcept { return mBox.extent[0] != 0; }
+
+    using ScaledPolynomial = std::pair<Coefficient, std::reference_wrapper<const BasicPolynomial>>;
+
+    /// @brief Вычислить сумму c1 * p1 + c2 * p2 + ... одним слиянием всех слагаемых
+    /// @param terms пары (коэффициент, полином)
+    static BasicPolynomial linearCombination(const std::vector<ScaledPolynomial>& terms);
+
+    /// @brief Задать число потоков для умножения больших полиномов (общее для всех конфигураций)
+    /// @param threadCount 1 - умножение в одном потоке (по умолчанию), 0 - по числу ядер процессора
+    static void setMultiplicationThreads(unsigned threadCount);
+    static unsigned multiplicationThreads() noexcept;
+
+    /// @brief Узнать, каким способом будет вычислено произведение *this * other (для настройки порогов)
+    MultiplicationStrategy multiplicationStrategy(const BasicPolynomial& other) const;
+
+    bool operator==(const BasicPolynomial& other) const;
+    bool operator!=(const BasicPolynomial& other) const;
+
+    // Перегрузки для rvalue используют память уничтожаемого операнда
+    BasicPolynomial operator+(const BasicPolynomial& other) const&;
+    BasicPolynomial operator+(const BasicPolynomial& other) &&;
+    BasicPolynomial operator+(BasicPolynomial&& other) const&;
+    BasicPolynomial operator+(BasicPolynomial&& other) &&;
+    BasicPolynomial& operator+=(const BasicPolynomial& other);
+    BasicPolynomial operator-() const&;
+    BasicPolynomial operator-() &&;
+    BasicPolynomial operator-(const BasicPolynomial& other) const&;
+    BasicPolynomial operator-(const BasicPolynomial& other) &&;
+    BasicPolynomial operator-(BasicPolynomial&& other) const&;
+    BasicPolynomial operator-(BasicPolynomial&& other) &&;
+    BasicPolynomial& operator-=(const BasicPolynomial& other);
+    BasicPolynomial operator*(const BasicPolynomial& other) const;
+    BasicPolynomial operator*(Coefficient coefficient) const&;
+    BasicPolynomial operator*(Coefficient coefficient) &&;
+    BasicPolynomial& operator*=(Coefficient coefficient);
+    BasicPolynomial square() const;
+    BasicPolynomial pow(unsigned long exponent) const;
+
+    /// @brief Оставить только мономы полной степени не больше maxTotalDegree
+    BasicPolynomial truncated(uint64_t maxTotalDegree) const;
+    /// @brief Вычислить произведение без мономов полной степени больше maxTotalDegree (отрезок степенного ряда).
+    /// Пары мономов, произведение которых выше границы, не перемножаются
+    BasicPolynomial mulTruncated(const BasicPolynomial& other, uint64_t maxTotalDegree) const;
+    /// @brief Возвести в степень без мономов полной степени больше maxTotalDegree
+    BasicPolynomial powTruncated(unsigned long exponent, uint64_t maxTotalDegree) const;
+
+    friend BasicPolynomial operator*(Coefficient coefficient, const BasicPolynomial& p)
+    {
+        return p * coefficient;
+    }
+
+    friend std::ostream& operator<<(std::ostream& ostr, const BasicPolynomial& p)
+    {
+        std::string text;
+        p.appendTo(text);
+        return ostr << text;
+    }
+
+    /// @brief Дописать текстовую запись полинома (в формате operator<<) в конец строки
+    /// @param maxLength наибольшее число дописываемых символов; если запись длиннее,
+    /// она обрывается на границе монома и завершается "..."
+    void appendTo(std::string& out, size_t maxLength = std::string::npos) const;
+
+    /// @brief Записать текстовую запись полинома в буфер [first, last), как std::to_chars
+    /// @return указатель за последним записанным символом или errc::value_too_large, если буфер мал
+    std::to_chars_result toChars(char* first, char* last) const noexcept;
+
+    /// @brief Вычислить значение полинома в точке
+    /// @param point значения переменных в порядке их упаковки (w, x, y, z при NVars = 4)
+    Coefficient evaluate(const std::array<Coefficient, NVars>& point) const;
+
+    template <typename... Values>
+        requires (sizeof...(Values) == NVars && (std::is_convertible_v<Values, Coefficient> && ...))
+    Coefficient evaluate(Values... values) const
+    {
+        return evaluate(std::array<Coefficient, NVars>{ static_cast<Coefficient>(values)... });
+    }
+
+    /// @brief Вычислить значения полинома сразу во многих точках
+    /// @param coordinates массивы координат точек длины count, по одному на переменную
+    /// @param result массив длины count, куда записываются значения
+    void evaluateBatch(const std::array<const double*, NVars>& coordinates, double* result, size_t count) const
+        requires IsFloatingPoint;
+
+    void evaluateBatch(const double* w, const double* x, const double* y, const double* z, double* result, size_t count) const
+        requires (NVars == 4 && IsFloatingPoint)
+    {
+        evaluateBatch({ w, x, y, z }, result, count);
+    }
+
+    template <typename... Vectors>
+        requires (sizeof...(Vectors) == NVars && IsFloatingPoint && (std::is_same_v<Vectors, std::vector<double>> && ...))
+    std::vector<double> evaluateBatch(const Vectors&... coordinates) const
+    {
+        const size_t count = std::get<0>(std::tie(coordinates...)).size();
+        if (((coordinates.size() != count) || ...))
+        {
+            throw std::invalid_argument(__FUNCTION__ ": coordinate arrays have different sizes.");
+        }
+
+        std::vector<double> result(count);
+        evaluateBatch({ coordinates.data()... }, result.data(), count);
+        return result;
+    }
+
+    // var: 0 - первая переменная (w при NVars = 4), NVars - 1 - последняя (z)
+    BasicPolynomial derivative(unsigned var) const;
+    BasicPolynomial integral(unsigned var) const;
+    void differentiate(unsigned var);
+    void integrate(unsigned var);
+
+    /// @brief Вычислить все частные производные за один проход по мономам
+    /// @return производные по переменным в порядке их упаковки
+    std::array<BasicPolynomial, NVars> gradient() const;
+
+    BasicPolynomial derivativeW() const requires (NVars == 4) { return derivative(0); }
+    BasicPolynomial derivativeX() const requires (NVars == 4) { return derivative(1); }
+    BasicPolynomial derivativeY() const requires (NVars == 4) { return derivative(2); }
+    BasicPolynomial derivativeZ() const requires (NVars == 4) { return derivative(3); }
+    BasicPolynomial integralX() const requires (NVars == 4) { return integral(1); }
+    BasicPolynomial integralY() const requires (NVars == 4) { return integral(2); }
+    BasicPolynomial integralZ() const requires (NVars == 4) { return integral(3); }
+    BasicPolynomial integralW() const requires (NVars == 4) { return integral(0); }
+
+    /// @brief Получить образ полинома с целыми коэффициентами по модулю
+    /// @param p полином с коэффициентами double; нецелый коэффициент - ошибка
+    static BasicPolynomial fromIntegerPolynomial(const BasicPolynomial<NVars, Bits>& p)
+        requires (!IsFloatingPoint);
+
+    /// @brief Восстановить полином с целыми коэффициентами по его образам по нескольким простым модулям
+    /// (китайская теорема об остатках). Коэффициенты восстанавливаются из диапазона |c| < M / 2,
+    /// где M - произведение модулей, и округляются до double
+    template <uint64_t... Moduli>
+        requires (IsFloatingPoint && sizeof...(Moduli) > 0)
+    static BasicPolynomial fromModularImages(const BasicPolynomial<NVars, Bits, ModInt<Moduli>>&... images)
+    {
+        if ((images.isDense() || ...))
+        {
+            return fromModularImages(images.sparseCopy()...);
+        }
+
+        const CrtReconstructor crt({ Moduli... });
+
+        std::vector<uint64_t> degrees;
+        (degrees.insert(degrees.end(), images.mDegrees.begin(), images.mDegrees.end()), ...);
+        std::sort(degrees.begin(), degrees.end(), std::greater<uint64_t>());
+        degrees.erase(std::unique(degrees.begin(), degrees.end()), degrees.end());
+
+        BasicPolynomial result;
+        result.reserve(degrees.size());
+
+        size_t positions[sizeof...(Moduli)] = {};
+        for (uint64_t degree : degrees)
+        {
+            // моном, отсутствующий в образе, имеет по этому модулю нулевой коэффициент
+            uint64_t residues[sizeof...(Moduli)];
+            size_t k = 0;
+            ((residues[k] = positions[k] < images.size() && images.mDegrees[positions[k]] == degree
+                ? images.mCoefficients[positions[k]++].value() : 0, ++k), ...);
+
+            const double coefficient = crt.reconstruct(residues);
+            if (coefficient != 0.0)
+            {
+                result.pushBack(degree, coefficient);
+            }
+        }
+
+        return result;
+    }
+};
+
+extern template class BasicPolynomial<4, 16>;
+extern template class BasicPolynomial<8, 8>;
+extern template class BasicPolynomial<2, 32>;
+extern template class BasicPolynomial<4, 16, ModInt<ModularPrime1>>;
+extern template class BasicPolynomial<4, 16, ModInt<ModularPrime2>>;
+extern template class BasicPolynomial<4, 16, ModInt<ModularPrime3>>;
+
+// Четыре переменные w, x, y, z со степенями до 65535
+using Polynomial = BasicPolynomial<4, 16>;
+
+// Полином от w, x, y, z с точными коэффициентами по простому модулю Modulus (ModularPrime1..3)
+template <uint64_t Modulus>
+using ModularPolynomial = BasicPolynomial<4, 16, ModInt<Modulus>>;
@@ -1,7 +1,11 @@
 ﻿#pragma once
+#include "memory_scope.h"
+#include <memory_resource>
+#include <new>
 #include <vector>
 #include <optional>
 
+// Узлы выделяются из ресурса памяти, заданного при создании дерева (по умолчанию - currentMemoryResource())
 template <typename K, typename V>
 class RedBlackTree
 {
@@ -27,15 +31,47 @@ private:
             if (pLeft != nullptr) pLeft->pParent = this;
             if (pRight != nullptr) pRight->pParent = this;
         }
-
-        static Node* createLeave()
-        {
-            return new Node(nullptr, nullptr, nullptr, BLACK, {}, {}, true);
-        }
     };
 
     Node* mpRoot;
     size_t mSize;
+    std::pmr::memory_resource* mpResource;
+
+    Node* createNode(Node* pParent, Node* pLeft, Node* pRight, typename Node::Color color, const K& key, const V& value, bool isLeaf)
+    {
+        void* memory = mpResource->allocate(sizeof(Node), alignof(Node));
+        try
+        {
+            return new (memory) Node(pParent, pLeft, pRight, color, key, value, isLeaf);
+        } catch (...)
+        {
+            mpResource->deallocate(memory, sizeof(Node), alignof(Node));
+            throw;
+        }
+    }
+
+    Node* createLeave()
+    {
+        return createNode(nullptr, nullptr, nullptr, Node::BLACK, {}, {}, true);
+    }
+
+    void destroyNode(Node* pNode) noexcept
+    {
+        pNode->~Node();
+        mpResource->deallocate(pNode, sizeof(Node), alignof(Node));
+    }
+
+    void destroySubtree(Node* pNode) noexcept
+    {
+        if (pNode == nullptr)
+        {
+            return;
+        }
+
+        destroySubtree(pNode->pLeft);
+        destroySubtree(pNode->pRight);
+        destroyNode(pNode);
+    }
 
     bool isRightChild(const Node* pNode)
     {
@@ -331,13 +367,13 @@ private:
             }
         }
 
-        delete pOtherChild;
-        delete pNode;
+        destroyNode(pOtherChild);
+        destroyNode(pNode);
 
         if (pChild->isLeaf && pChild == mpRoot)
         {
             mpRoot = nullptr;
-            delete pChild;
+            destroyNode(pChild);
         }
     }
 
@@ -401,12 +437,25 @@ private:
     }
 
 public:
-    RedBlackTree() : mpRoot(nullptr), mSize(0) {}
+    RedBlackTree() : RedBlackTree(currentMemoryResource()) {}
+    explicit RedBlackTree(std::pmr::memory_resource* resource) : mpRoot(nullptr), mSize(0), mpResource(resource) {}
+
+    RedBlackTree(const RedBlackTree&) = delete;
+    RedBlackTree& operator=(const RedBlackTree&) = delete;
+
+    ~RedBlackTree()
+    {
+        destroySubtree(mpRoot);
+    }
 
     size_t size() const noexcept { return mSize; }
+    std::pmr::memory_resource* resource() const noexcept { return mpResource; }
     bool empty() const noexcept { return mSize == 0; }
 
-    std::optional<V> find(const K& key) const
+    // Поиск и удаление принимают любой ключ, сравнимый с K (например, std::string_view для std::string),
+    // поэтому ключ не нужно копировать в K
+    template <typename Key = K>
+    std::optional<V> find(const Key& key) const
     {
         if (mpRoot == nullptr)
         {
@@ -439,7 +488,7 @@ public:
     {
         if (mpRoot == nullptr)
         {
-            mpRoot = new Node(nullptr, Node::createLeave(), Node::createLeave(), Node::RED, key, value, false);
+            mpRoot = createNode(nullptr, createLeave(), createLeave(), Node::RED, key, value, false);
             fixInsert(mpRoot);
             mSize++;
             return;
@@ -463,11 +512,11 @@ public:
             Node* pNew;
             if (isLeftChild(pCur))
             {
-                pNew = new Node(pCur->pParent, pCur, Node::createLeave(), Node::RED, key, value, false);
+                pNew = createNode(pCur->pParent, pCur, createLeave(), Node::RED, key, value, false);
                 pNew->pParent->pLeft = pNew;
             } else
             {
-                pNew = new Node(pCur->pParent, pCur, Node::createLeave(), Node::RED, key, value, false);
+                pNew = createNode(pCur->pParent, pCur, createLeave(), Node::RED, key, value, false);
                 pNew->pParent->pRight = pNew;
             }
             fixInsert(pNew);
@@ -478,7 +527,8 @@ public:
         }
     }
 
-    bool erase(const K& key)
+    template <typename Key = K>
+    bool erase(const Key& key)
     {
         if (mpRoot == nullptr)
         {
@@ -0,0 +1,235 @@
+#pragma once
+
+#include "memory_scope.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory_resource>
+#include <type_traits>
+
+// Динамический массив, первые InlineCapacity элементов которого хранятся внутри объекта.
+// Память в куче выделяется, только когда размер превышает InlineCapacity.
+// Поддерживаются только тривиально копируемые типы, элементы копируются через memcpy.
+// Память в куче берется из ресурса, который был текущим (currentMemoryResource) при создании массива;
+// как в std::pmr, копия получает текущий ресурс, а перемещение между разными ресурсами копирует элементы
+template <typename T, size_t InlineCapacity>
+class SmallVector
+{
+    static_assert(std::is_trivially_copyable_v<T>, "SmallVector supports only trivially copyable types");
+    static_assert(InlineCapacity > 0, "Inline capacity must be positive");
+
+public:
+    using value_type = T;
+    using iterator = T*;
+    using const_iterator = const T*;
+
+    SmallVector() noexcept : mpData(mInline), mSize(0), mCapacity(InlineCapacity), mpResource(currentMemoryResource()) {}
+
+    SmallVector(const SmallVector& other) : SmallVector()
+    {
+        assign(other.begin(), other.end());
+    }
+
+    SmallVector(SmallVector&& other) noexcept : mpData(mInline), mSize(0), mCapacity(InlineCapacity), mpResource(other.mpResource)
+    {
+        moveFrom(other);
+    }
+
+    ~SmallVector()
+    {
+        release();
+    }
+
+    SmallVector& operator=(const SmallVector& other)
+    {
+        if (this != &other)
+        {
+            assign(other.begin(), other.end());
+        }
+
+        return *this;
+    }
+
+    SmallVector& operator=(SmallVector&& other)
+    {
+        if (mpResource != other.mpResource && *mpResource != *other.mpResource)
+        {
+            // память other нельзя освободить через свой ресурс
+            assign(other.begin(), other.end());
+            other.clear();
+            return *this;
+        }
+
+        if (this != &other)
+        {
+            release();
+            mpData = mInline;
+            mSize = 0;
+            mCapacity = InlineCapacity;
+            moveFrom(other);
+        }
+
+        return *this;
+    }
+
+    size_t size() const noexcept { return mSize; }
+    size_t capacity() const noexcept { return mCapacity; }
+    bool empty() const noexcept { return mSize == 0; }
+    bool isInline() const noexcept { return mpData == mInline; }
+    std::pmr::memory_resource* resource() const noexcept { return mpResource; }
+
+    T* data() noexcept { return mpData; }
+    const T* data() const noexcept { return mpData; }
+    iterator begin() noexcept { return mpData; }
+    iterator end() noexcept { return mpData + mSize; }
+    const_iterator begin() const noexcept { return mpData; }
+    const_iterator end() const noexcept { return mpData + mSize; }
+
+    T& operator[](size_t index) noexcept { return mpData[index]; }
+    const T& operator[](size_t index) const noexcept { return mpData[index]; }
+    T& front() noexcept { return mpData[0]; }
+    const T& front() const noexcept { return mpData[0]; }
+    T& back() noexcept { return mpData[mSize - 1]; }
+    const T& back() const noexcept { return mpData[mSize - 1]; }
+
+    void reserve(size_t newCapacity)
+    {
+        if (newCapacity <= mCapacity)
+        {
+            return;
+        }
+
+        T* tmp = static_cast<T*>(mpResource->allocate(newCapacity * sizeof(T), alignof(T)));
+        if (mSize != 0)
+        {
+            std::memcpy(tmp, mpData, mSize * sizeof(T));
+        }
+        release();
+
+        mpData = tmp;
+        mCapacity = newCapacity;
+    }
+
+    void resize(size_t newSize, const T& value = T())
+    {
+        if (newSize > mCapacity)
+        {
+            reserve(std::max(newSize, mCapacity * 2));
+        }
+        if (newSize > mSize)
+        {
+            std::fill(mpData + mSize, mpData + newSize, value);
+        }
+
+        mSize = newSize;
+    }
+
+    void clear() noexcept
+    {
+        mSize = 0;
+    }
+
+    void push_back(const T& value)
+    {
+        if (mSize == mCapacity)
+        {
+            T copy = value; // value может указывать внутрь массива
+            reserve(mCapacity * 2);
+            mpData[mSize++] = copy;
+            return;
+        }
+
+        mpData[mSize++] = value;
+    }
+
+    void pop_back() noexcept
+    {
+        --mSize;
+    }
+
+    template <typename It>
+    void assign(It first, It last)
+    {
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+        mSize = 0;
+        reserve(count);
+        std::copy(first, last, mpData);
+        mSize = count;
+    }
+
+    // Источник [first, last) не должен указывать внутрь этого же массива
+    template <typename It>
+    iterator insert(const_iterator pos, It first, It last)
+    {
+        const size_t offset = static_cast<size_t>(pos - mpData);
+        const size_t count = static_cast<size_t>(std::distance(first, last));
+
+        if (mSize + count > mCapacity)
+        {
+            reserve(std::max(mSize + count, mCapacity * 2));
+        }
+
+        T* at = mpData + offset;
+        std::memmove(at + count, at, (mSize - offset) * sizeof(T));
+        std::copy(first, last, at);
+        mSize += count;
+
+        return at;
+    }
+
+    iterator erase(const_iterator first, const_iterator last) noexcept
+    {
+        T* from = mpData + (first - mpData);
+        const size_t count = static_cast<size_t>(last - first);
+
+        std::memmove(from, from + count, (end() - (from + count)) * sizeof(T));
+        mSize -= count;
+
+        return from;
+    }
+
+    friend bool operator==(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return std::equal(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
+    }
+
+    friend bool operator!=(const SmallVector& lhs, const SmallVector& rhs)
+    {
+        return !(lhs == rhs);
+    }
+
+private:
+    T* mpData;
+    size_t mSize;
+    size_t mCapacity;
+    std::pmr::memory_resource* mpResource;
+    T mInline[InlineCapacity];
+
+    void release() noexcept
+    {
+        if (mpData != mInline)
+        {
+            mpResource->deallocate(mpData, mCapacity * sizeof(T), alignof(T));
+        }
+    }
+
+    // this должен быть пустым, хранить элементы внутри себя и иметь тот же ресурс, что и other
+    void moveFrom(SmallVector& other) noexcept
+    {
+        if (other.isInline())
+        {
+            std::memcpy(mInline, other.mInline, other.mSize * sizeof(T));
+            mSize = other.mSize;
+        } else
+        {
+            mpData = other.mpData;
+            mSize = other.mSize;
+            mCapacity = other.mCapacity;
+
+            other.mpData = other.mInline;
+            other.mCapacity = InlineCapacity;
+        }
+
+        other.mSize = 0;
+    }
+};
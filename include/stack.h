@@ -1,28 +1,38 @@
 #pragma once
 
-#include <stdexcept>
+#include "memory_scope.h"
+#include <algorithm>
 #include <iostream>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <stdexcept>
 
 #define STR1(x)  #x
 #define STR(x)  STR1(x)
 
 const int MaxStackSize = 100000000;
 
+// Элементы хранятся в памяти из ресурса, заданного при создании стека (по умолчанию - currentMemoryResource()).
+// Элемент создается при push и уничтожается при pop
 template <typename T>
 class Stack
 {
 public:
-    Stack(size_t sizeToReserve = 0) : mCapacity(0), mSize(0), mpMemory(nullptr)
+    Stack(size_t sizeToReserve = 0) : Stack(sizeToReserve, currentMemoryResource()) {}
+
+    Stack(size_t sizeToReserve, std::pmr::memory_resource* resource) : mCapacity(0), mSize(0), mpMemory(nullptr), mpResource(resource)
     {
         reserve(sizeToReserve);
     }
 
-    Stack(const Stack& other)
+    explicit Stack(std::pmr::memory_resource* resource) : Stack(0, resource) {}
+
+    Stack(const Stack& other) : mCapacity(0), mSize(0), mpMemory(nullptr), mpResource(currentMemoryResource())
     {
-        mCapacity = other.mCapacity;
+        reserve(other.mCapacity);
+        std::uninitialized_copy(other.mpMemory, other.mpMemory + other.mSize, mpMemory);
         mSize = other.mSize;
-        mpMemory = new T[mSize];
-        std::copy(other.mpMemory, other.mpMemory + mSize, mpMemory);
     }
 
     Stack(Stack&& other) noexcept
@@ -30,6 +40,7 @@ public:
         mCapacity = other.mCapacity;
         mSize = other.mSize;
         mpMemory = other.mpMemory;
+        mpResource = other.mpResource;
 
         other.mSize = 0;
         other.mCapacity = 0;
@@ -38,32 +49,46 @@ public:
 
     ~Stack()
     {
-        delete[] mpMemory;
+        release();
     }
 
     Stack& operator=(const Stack& other)
     {
+        if (this == &other)
+        {
+            return *this;
+        }
+
+        clear();
         if (other.mCapacity > mCapacity)
         {
-            T* tmp = new T[other.mCapacity];
-            delete[] mpMemory;
-            mpMemory = tmp;
+            release();
+            mpMemory = allocate(other.mCapacity);
             mCapacity = other.mCapacity;
         }
 
+        std::uninitialized_copy(other.mpMemory, other.mpMemory + other.mSize, mpMemory);
         mSize = other.mSize;
-        std::copy(other.mpMemory, other.mpMemory + mSize, mpMemory);
 
         return *this;
     }
 
-    Stack& operator=(Stack&& other) noexcept
+    Stack& operator=(Stack&& other)
     {
         if (mpMemory == other.mpMemory)
         {
             return *this;
         }
 
+        // память other нельзя освободить через свой ресурс - копируем
+        if (mpResource != other.mpResource && *mpResource != *other.mpResource)
+        {
+            *this = other;
+            other.clear();
+            return *this;
+        }
+
+        release();
         mCapacity = other.mCapacity;
         mSize = other.mSize;
         mpMemory = other.mpMemory;
@@ -91,6 +116,11 @@ public:
         return size() == 0;
     }
 
+    std::pmr::memory_resource* resource() const noexcept
+    {
+        return mpResource;
+    }
+
     const T& top() const
     {
         if (empty())
@@ -101,6 +131,16 @@ public:
         return mpMemory[size() - 1];
     }
 
+    T& top()
+    {
+        if (empty())
+        {
+            throw std::logic_error("Stack is empty");
+        }
+
+        return mpMemory[size() - 1];
+    }
+
     void pop()
     {
         if (empty())
@@ -108,17 +148,22 @@ public:
             throw std::logic_error("Can't pop from empty stack");
         }
 
-        --mSize;
+        std::destroy_at(mpMemory + --mSize);
     }
 
     void push(const T& elem)
     {
         if (mSize == mCapacity)
         {
+            T copy = elem; // elem может лежать в этом же стеке
             expand();
+            ::new (static_cast<void*>(mpMemory + mSize)) T(std::move(copy));
+        } else
+        {
+            ::new (static_cast<void*>(mpMemory + mSize)) T(elem);
         }
 
-        mpMemory[mSize++] = elem;
+        ++mSize;
     }
 
     void push(T&& elem)
@@ -128,7 +173,14 @@ public:
             expand();
         }
 
-        mpMemory[mSize++] = std::move(elem);
+        ::new (static_cast<void*>(mpMemory + mSize)) T(std::move(elem));
+        ++mSize;
+    }
+
+    void clear() noexcept
+    {
+        std::destroy(mpMemory, mpMemory + mSize);
+        mSize = 0;
     }
 
     void reserve(size_t newCapacity)
@@ -143,12 +195,14 @@ public:
             return;
         }
 
-        T* tmp = new T[newCapacity];
+        T* tmp = allocate(newCapacity);
 
         if (mpMemory != nullptr)
         {
-            std::copy(mpMemory, mpMemory + mSize, tmp);
-            delete[] mpMemory;
+            std::uninitialized_move(mpMemory, mpMemory + mSize, tmp);
+            const size_t size = mSize;
+            release();
+            mSize = size;
         }
 
         mCapacity = newCapacity;
@@ -160,6 +214,7 @@ public:
         std::swap(lhs.mSize, rhs.mSize);
         std::swap(lhs.mCapacity, rhs.mCapacity);
         std::swap(lhs.mpMemory, rhs.mpMemory);
+        std::swap(lhs.mpResource, rhs.mpResource);
     }
 
     friend std::ostream& operator<<(std::ostream& os, const Stack& s)
@@ -176,6 +231,24 @@ private:
     T* mpMemory;
     size_t mCapacity;
     size_t mSize;
+    std::pmr::memory_resource* mpResource;
+
+    T* allocate(size_t count)
+    {
+        return static_cast<T*>(mpResource->allocate(count * sizeof(T), alignof(T)));
+    }
+
+    // уничтожить элементы и вернуть память ресурсу
+    void release() noexcept
+    {
+        clear();
+        if (mpMemory != nullptr)
+        {
+            mpResource->deallocate(mpMemory, mCapacity * sizeof(T), alignof(T));
+            mpMemory = nullptr;
+        }
+        mCapacity = 0;
+    }
 
     void expand()
     {
@@ -184,4 +257,4 @@ private:
         size_t newCapacity = std::max((size_t)1, mCapacity * reallocationFactor);
         reserve(newCapacity);
     }
-};
\ No newline at end of file
+};
@@ -1,20 +1,31 @@
 #pragma once
 #include "polynomial.h"
 #include "red_black_tree.h"
+#include <cstdint>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <optional>
 
+// Immutable polynomial shared by the tables that store it. A lookup copies the pointer, not the monomials;
+// the polynomial stays alive while any handle to it exists, even after it is deleted from the table
+using PolynomialHandle = std::shared_ptr<const Polynomial>;
+
 class Table
 {
 public:
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) = 0; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) = 0;
-    virtual void delPolynomial(const std::string& polName) = 0;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) = 0; // find polynomial named polName, nullptr if there is none
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) = 0; // store the handle itself, the polynomial is not copied
+    void addPolynomial(const std::string& polName, const Polynomial& pol)
+    {
+        addPolynomial(polName, std::make_shared<const Polynomial>(pol));
+    }
+    virtual void delPolynomial(std::string_view polName) = 0;
     virtual unsigned int size() = 0;
     virtual bool empty() = 0;
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() = 0;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() = 0; // names with shared handles, the polynomials are not copied
 
     virtual ~Table() = 0 {}; // removed {}, may be its bad
 };
@@ -25,7 +36,7 @@ private:
     struct Pol
     {
         std::string key;
-        Polynomial value;
+        PolynomialHandle value;
     };
 
     std::vector<Pol> mTable;
@@ -33,12 +44,13 @@ private:
 public:
     LinearArrTable();
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) override; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) override;
-    virtual void delPolynomial(const std::string& polName) override;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
     virtual unsigned int size() override;
     virtual bool empty();
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
 
 
     virtual ~LinearArrTable() {};
@@ -51,7 +63,7 @@ private:
     struct Node
     {
         std::string key;
-        Polynomial value;
+        PolynomialHandle value;
         Node* pNext;
     };
     Node* pFirst;
@@ -60,12 +72,13 @@ private:
 public:
     LinearListTable();
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) override; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) override;
-    virtual void delPolynomial(const std::string& polName) override;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
     virtual unsigned int size() override;
     virtual bool empty() override;
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
 
     virtual ~LinearListTable();
 };
@@ -77,7 +90,7 @@ private:
     struct Pol
     {
         std::string key;
-        Polynomial value;
+        PolynomialHandle value;
     };
 
     std::vector<Pol> mTable;
@@ -85,12 +98,13 @@ private:
 public:
     OrderedTable();
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) override; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) override;
-    virtual void delPolynomial(const std::string& polName) override;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
     virtual unsigned int size() override;
     virtual bool empty() override;
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
 
     virtual ~OrderedTable() {};
 };
@@ -99,47 +113,57 @@ public:
 class TreeTable : public Table
 {
 private:
-    RedBlackTree<std::string, Polynomial> mTree;
+    RedBlackTree<std::string, PolynomialHandle> mTree;
 public:
     TreeTable();
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) override; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) override;
-    virtual void delPolynomial(const std::string& polName) override;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
     virtual unsigned int size() override;
     virtual bool empty() override;
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
 
     virtual ~TreeTable() {};
 };
 
 
+// Robin Hood open addressing with linear probing: a key that is further from its home slot takes the
+// place of a closer one, so probe lengths stay short and even. Deletion shifts the following keys back
+// instead of leaving tombstones
 class OpenAddressHashTable : public Table
 {
 private:
     struct Node
     {
-        int status; // 1 - , 0 - , -1 - 
+        int distance = -1; //    , -1 -  
+        size_t hash = 0;
         std::string key;
-        Polynomial value;
+        PolynomialHandle value;
     };
 
-    std::vector<Node> mTable;
-    size_t step;
-    size_t mTableSize;
+    std::vector<Node> mTable; // capacity is a power of two
     size_t mCurrentSize;
 
-    unsigned int hashFunc(const std::string& key);
+    static size_t hashFunc(std::string_view key);
+    size_t findIndex(std::string_view key) const; // index of the key or mTable.size() if there is none
+    void insertNode(Node node);
+    void rehash(size_t capacity);
 
 public:
     OpenAddressHashTable();
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) override; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) override;
-    virtual void delPolynomial(const std::string& polName) override;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
     virtual unsigned int size() override;
     virtual bool empty() override;
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
+
+    size_t capacity() const { return mTable.size(); }
+    size_t maxProbeLength() const; // the largest distance of a stored key from its home slot
 
     virtual ~OpenAddressHashTable() {};
 };
@@ -151,7 +175,7 @@ private:
     struct Node
     {
         std::string key;
-        Polynomial value;
+        PolynomialHandle value;
         Node* pNextInChain;
     };
 
@@ -159,23 +183,63 @@ private:
     size_t mTableSize;
     size_t mCurrentSize;
 
-    unsigned int hashFunc(const std::string& key);
+    unsigned int hashFunc(std::string_view key);
 
 public:
 
     SeparateChainingHashTable();
 
-    virtual std::optional<Polynomial> findPolynomial(const std::string& polName) override; // find polynomial named polName
-    virtual void addPolynomial(const std::string& polName, const Polynomial& pol) override;
-    virtual void delPolynomial(const std::string& polName) override;
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
     virtual unsigned int size() override;
     virtual bool empty() override;
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
 
     virtual ~SeparateChainingHashTable() {};
 };
 
 
+// Swiss-table style open addressing. Slots are split into groups of 16; every slot has a control byte
+// holding the 7 low bits of the key hash (or "empty"/"deleted"), and the 16 control bytes of a group
+// are matched against the tag at once (SSE2 where available), so keys are compared only on a tag hit
+class SwissHashTable : public Table
+{
+private:
+    struct Slot
+    {
+        std::string key;
+        PolynomialHandle value;
+    };
+
+    std::vector<int8_t> mControl; //   0..127   ,  Empty  Deleted
+    std::vector<Slot> mSlots;     // capacity is a power of two, at least one group
+    size_t mCurrentSize;
+    size_t mDeleted;
+
+    static size_t hashFunc(std::string_view key);
+    size_t findIndex(std::string_view key) const; // index of the key or mSlots.size() if there is none
+    size_t findFreeSlot(size_t hash) const;
+    void rehash(size_t capacity);
+
+public:
+    SwissHashTable();
+
+    virtual PolynomialHandle findPolynomial(std::string_view polName) override; // find polynomial named polName
+    using Table::addPolynomial;
+    virtual void addPolynomial(const std::string& polName, PolynomialHandle pol) override;
+    virtual void delPolynomial(std::string_view polName) override;
+    virtual unsigned int size() override;
+    virtual bool empty() override;
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials() override;
+
+    size_t capacity() const { return mSlots.size(); }
+
+    virtual ~SwissHashTable() {};
+};
+
+
 class Aggregator
 {
 private:
@@ -191,12 +255,14 @@ public:
     //							  mTables[3] - mTree (short for mTree table - contains TreeTable object)
     //							  mTables[4] - opha (short for open Address hash table - contains OpenAddressHashTable object)
     //							  mTables[5] - seha (short for separate chaining hash table - contains SeparateChainingHashTable object)
-    std::optional<Polynomial> findPolynomial(const std::string& polName); // find polynomial named polName
+    //							  mTables[6] - swis (short for swiss table - contains SwissHashTable object)
+    PolynomialHandle findPolynomial(std::string_view polName); // find polynomial named polName, nullptr if there is none
     void addPolynomial(const std::string& polName, const Polynomial& pol);
-    void delPolynomial(const std::string& polName);
+    void addPolynomial(const std::string& polName, PolynomialHandle pol); // all tables share this one immutable copy
+    void delPolynomial(std::string_view polName);
     unsigned int size();
     bool empty();
-    virtual std::vector<std::pair< std::string, Polynomial>> getPolynomials();
+    virtual std::vector<std::pair< std::string, PolynomialHandle>> getPolynomials();
 
     ~Aggregator();
 };
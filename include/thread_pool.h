@@ -0,0 +1,94 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+class ThreadPool
+{
+private:
+    std::vector<std::thread> mWorkers;
+    std::queue<std::function<void()>> mTasks;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mStopping;
+
+    void workerLoop()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+            {
+                std::unique_lock<std::mutex> lock(mMutex);
+                mCondition.wait(lock, [this] { return mStopping || !mTasks.empty(); });
+
+                if (mStopping && mTasks.empty())
+                {
+                    return;
+                }
+
+                task = std::move(mTasks.front());
+                mTasks.pop();
+            }
+
+            task();
+        }
+    }
+
+public:
+    explicit ThreadPool(size_t threadCount) : mStopping(false)
+    {
+        if (threadCount == 0)
+        {
+            throw std::invalid_argument(__FUNCTION__ ": thread count must be positive.");
+        }
+
+        mWorkers.reserve(threadCount);
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            mWorkers.emplace_back([this] { workerLoop(); });
+        }
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    ~ThreadPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mStopping = true;
+        }
+
+        mCondition.notify_all();
+        for (auto& worker : mWorkers)
+        {
+            worker.join();
+        }
+    }
+
+    size_t size() const noexcept { return mWorkers.size(); }
+
+    /// @brief Поставить задачу в очередь
+    /// @return future с результатом задачи (исключение задачи пробрасывается из future::get)
+    template <typename F>
+    std::future<std::invoke_result_t<F>> submit(F&& task)
+    {
+        using Result = std::invoke_result_t<F>;
+
+        auto pTask = std::make_shared<std::packaged_task<Result()>>(std::forward<F>(task));
+        std::future<Result> res = pTask->get_future();
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mTasks.push([pTask] { (*pTask)(); });
+        }
+
+        mCondition.notify_one();
+        return res;
+    }
+};
\ No newline at end of file
@@ -48,6 +48,8 @@ namespace Compiler {
         { Lexer::TokenType::NONE, Lexer::TokenType::INTY },
         { Lexer::TokenType::NONE, Lexer::TokenType::INTZ },
         { Lexer::TokenType::NONE, Lexer::TokenType::INTW },
+        { Lexer::TokenType::NONE, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::NONE, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::FLOAT, Lexer::TokenType::X },
         { Lexer::TokenType::FLOAT, Lexer::TokenType::Y },
         { Lexer::TokenType::FLOAT, Lexer::TokenType::Z },
@@ -72,6 +74,7 @@ namespace Compiler {
         { Lexer::TokenType::ID, Lexer::TokenType::PLUS },
         { Lexer::TokenType::ID, Lexer::TokenType::MINUS },
         { Lexer::TokenType::ID, Lexer::TokenType::MULT },
+        { Lexer::TokenType::ID, Lexer::TokenType::CARET },
         { Lexer::TokenType::ID, Lexer::TokenType::ASSIGN },
         { Lexer::TokenType::ID, Lexer::TokenType::COMMA },
         { Lexer::TokenType::ID, Lexer::TokenType::ENDOFFILE },
@@ -141,10 +144,13 @@ namespace Compiler {
         { Lexer::TokenType::LPAR, Lexer::TokenType::INTY },
         { Lexer::TokenType::LPAR, Lexer::TokenType::INTZ },
         { Lexer::TokenType::LPAR, Lexer::TokenType::INTW },
+        { Lexer::TokenType::LPAR, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::LPAR, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::RPAR, Lexer::TokenType::RPAR },
         { Lexer::TokenType::RPAR, Lexer::TokenType::PLUS },
         { Lexer::TokenType::RPAR, Lexer::TokenType::MINUS },
         { Lexer::TokenType::RPAR, Lexer::TokenType::MULT },
+        { Lexer::TokenType::RPAR, Lexer::TokenType::CARET },
         { Lexer::TokenType::RPAR, Lexer::TokenType::COMMA },
         { Lexer::TokenType::RPAR, Lexer::TokenType::ENDOFFILE },
         { Lexer::TokenType::PLUS, Lexer::TokenType::FLOAT },
@@ -164,6 +170,8 @@ namespace Compiler {
         { Lexer::TokenType::PLUS, Lexer::TokenType::INTY },
         { Lexer::TokenType::PLUS, Lexer::TokenType::INTZ },
         { Lexer::TokenType::PLUS, Lexer::TokenType::INTW },
+        { Lexer::TokenType::PLUS, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::PLUS, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::MINUS, Lexer::TokenType::FLOAT },
         { Lexer::TokenType::MINUS, Lexer::TokenType::INT },
         { Lexer::TokenType::MINUS, Lexer::TokenType::ID },
@@ -181,6 +189,8 @@ namespace Compiler {
         { Lexer::TokenType::MINUS, Lexer::TokenType::INTY },
         { Lexer::TokenType::MINUS, Lexer::TokenType::INTZ },
         { Lexer::TokenType::MINUS, Lexer::TokenType::INTW },
+        { Lexer::TokenType::MINUS, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::MINUS, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::MULT, Lexer::TokenType::FLOAT },
         { Lexer::TokenType::MULT, Lexer::TokenType::INT },
         { Lexer::TokenType::MULT, Lexer::TokenType::ID },
@@ -198,6 +208,8 @@ namespace Compiler {
         { Lexer::TokenType::MULT, Lexer::TokenType::INTY },
         { Lexer::TokenType::MULT, Lexer::TokenType::INTZ },
         { Lexer::TokenType::MULT, Lexer::TokenType::INTW },
+        { Lexer::TokenType::MULT, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::MULT, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::CARET, Lexer::TokenType::INT },
         { Lexer::TokenType::ASSIGN, Lexer::TokenType::FLOAT },
         { Lexer::TokenType::ASSIGN, Lexer::TokenType::INT },
@@ -217,6 +229,8 @@ namespace Compiler {
         { Lexer::TokenType::ASSIGN, Lexer::TokenType::INTY },
         { Lexer::TokenType::ASSIGN, Lexer::TokenType::INTZ },
         { Lexer::TokenType::ASSIGN, Lexer::TokenType::INTW },
+        { Lexer::TokenType::ASSIGN, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::ASSIGN, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::COMMA, Lexer::TokenType::FLOAT },
         { Lexer::TokenType::COMMA, Lexer::TokenType::INT },
         { Lexer::TokenType::COMMA, Lexer::TokenType::ID },
@@ -235,6 +249,8 @@ namespace Compiler {
         { Lexer::TokenType::COMMA, Lexer::TokenType::INTY },
         { Lexer::TokenType::COMMA, Lexer::TokenType::INTZ },
         { Lexer::TokenType::COMMA, Lexer::TokenType::INTW },
+        { Lexer::TokenType::COMMA, Lexer::TokenType::TRUNCMUL },
+        { Lexer::TokenType::COMMA, Lexer::TokenType::TRUNCPOW },
         { Lexer::TokenType::CALC, Lexer::TokenType::LPAR },
         { Lexer::TokenType::DERX, Lexer::TokenType::LPAR },
         { Lexer::TokenType::DERY, Lexer::TokenType::LPAR },
@@ -243,7 +259,9 @@ namespace Compiler {
         { Lexer::TokenType::INTX, Lexer::TokenType::LPAR },
         { Lexer::TokenType::INTY, Lexer::TokenType::LPAR },
         { Lexer::TokenType::INTZ, Lexer::TokenType::LPAR },
-        { Lexer::TokenType::INTW, Lexer::TokenType::LPAR }
+        { Lexer::TokenType::INTW, Lexer::TokenType::LPAR },
+        { Lexer::TokenType::TRUNCMUL, Lexer::TokenType::LPAR },
+        { Lexer::TokenType::TRUNCPOW, Lexer::TokenType::LPAR }
     };
 
     bool validateToken(TokenType prev, TokenType cur)
@@ -280,6 +298,8 @@ namespace Compiler {
         case TokenType::INTY:
         case TokenType::INTZ:
         case TokenType::INTW:
+        case TokenType::TRUNCMUL:
+        case TokenType::TRUNCPOW:
             return true;
         default:
             return false;
@@ -299,6 +319,8 @@ namespace Compiler {
         case TokenType::INTY:
         case TokenType::INTZ:
         case TokenType::INTW:
+        case TokenType::TRUNCMUL:
+        case TokenType::TRUNCPOW:
             return true;
         default:
             return false;
@@ -318,6 +340,8 @@ namespace Compiler {
         case TokenType::INTY: return 0;
         case TokenType::INTZ: return 0;
         case TokenType::INTW: return 0;
+        case TokenType::TRUNCMUL: return 2;
+        case TokenType::TRUNCPOW: return 2;
         default:
             throw std::invalid_argument(__FUNCTION__ ": Unknown operation provided");
         }
@@ -340,7 +364,9 @@ namespace Compiler {
         case TokenType::INTX:
         case TokenType::INTY:
         case TokenType::INTZ:
-        case TokenType::INTW: return PostfixMember(token, 0, true);
+        case TokenType::INTW:
+        case TokenType::TRUNCMUL:
+        case TokenType::TRUNCPOW: return PostfixMember(token, 0, true);
         case TokenType::LPAR: return PostfixMember(token);
         case TokenType::ID: return PostfixMember(token);
         default: throw std::invalid_argument(__FUNCTION__ ": Unknown operation provided");
@@ -381,6 +407,8 @@ namespace Compiler {
         { TokenType::INTY, OpInfo(Intr::Opcode::INTY, PostfixType::POLYNOMIAL, { (int)PostfixType::ANY })},
         { TokenType::INTZ, OpInfo(Intr::Opcode::INTZ, PostfixType::POLYNOMIAL, { (int)PostfixType::ANY })},
         { TokenType::INTW, OpInfo(Intr::Opcode::INTW, PostfixType::POLYNOMIAL, { (int)PostfixType::ANY })},
+        { TokenType::TRUNCMUL, OpInfo(Intr::Opcode::TRUNCMUL, PostfixType::POLYNOMIAL, { (int)PostfixType::ANY, (int)PostfixType::ANY, (int)PostfixType::INT })},
+        { TokenType::TRUNCPOW, OpInfo(Intr::Opcode::TRUNCPOW, PostfixType::POLYNOMIAL, { (int)PostfixType::ANY, (int)PostfixType::INT, (int)PostfixType::INT })},
         { TokenType::MINUS, OpInfo(Intr::Opcode::UMINUS, PostfixType::FLOAT, { (int)PostfixType::FLOAT, })},
         { TokenType::MINUS, OpInfo(Intr::Opcode::UMINUS, PostfixType::FLOAT, { (int)PostfixType::INT, })},
         { TokenType::MINUS, OpInfo(Intr::Opcode::UMINUS, PostfixType::POLYNOMIAL, { (int)PostfixType::POLYNOMIAL, })},
@@ -445,7 +473,8 @@ namespace Compiler {
                 return op.opcode;
             }
 
-            throw std::runtime_error(__FUNCTION__ ": compilation error occurred.");
+            // ,     truncmul  -  truncpow
+            throw SyntaxError{ member.token().startPos(), "Invalid operand types" };
         }
 
         void compileToTok(const std::vector<TokenType>& types, bool popFound)
@@ -640,7 +669,7 @@ namespace Compiler {
                     try
                     {
                         double val = std::stod(tok.value());
-                        types.push(PostfixType::INT);
+                        types.push(PostfixType::FLOAT);
                         prog.push_back(val);
                     }
                     catch (std::out_of_range)
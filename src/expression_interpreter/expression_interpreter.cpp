@@ -1,13 +1,93 @@
 #include "expression_interpreter/expression_interpreter.h"
+#include "memory_scope.h"
 #include "table.h"
+#include <cstddef>
+#include <memory_resource>
 
 namespace Intr {
 
     class VirtualMachine final
     {
     private:
+        // Полином-операнд: вычисленный (value) или найденный в таблице по имени (stored).
+        // Найденный полином не копируется, пока его не нужно изменить
+        struct PolynomialOperand
+        {
+            Polynomial value;
+            PolynomialHandle stored;
+
+            const Polynomial& get() const
+            {
+                return stored ? *stored : value;
+            }
+
+            Polynomial take()
+            {
+                return stored ? Polynomial(*stored) : std::move(value);
+            }
+        };
+
+        // Отложенная сумма: цепочка сложений и вычитаний копит слагаемые и вычисляется
+        // одним слиянием (Polynomial::linearCombination), когда результат понадобится.
+        // На стеке операндов ее место занимает пустой полином на позиции depth
+        struct PendingSum
+        {
+            size_t depth;
+            std::vector<std::pair<double, PolynomialOperand>> terms;
+        };
+
         Aggregator* pAggregator;
+        std::pmr::memory_resource* mpPersistentResource; // память для полиномов, которые сохраняются в таблицах
         Stack<Op> mOperands;
+        std::vector<PendingSum> mPendingSums;
+
+        bool isPendingSumOnTop() const
+        {
+            return !mPendingSums.empty() && mPendingSums.back().depth + 1 == mOperands.size();
+        }
+
+        PendingSum popPendingSum()
+        {
+            PendingSum sum = std::move(mPendingSums.back());
+            mPendingSums.pop_back();
+            mOperands.pop();
+            return sum;
+        }
+
+        static Polynomial evaluatePendingSum(const PendingSum& sum)
+        {
+            std::vector<Polynomial::ScaledPolynomial> terms;
+            terms.reserve(sum.terms.size());
+            for (const auto& term : sum.terms)
+            {
+                terms.emplace_back(term.first, std::cref(term.second.get()));
+            }
+
+            return Polynomial::linearCombination(terms);
+        }
+
+        void pushPendingSum(PendingSum&& sum)
+        {
+            sum.depth = mOperands.size();
+            mOperands.push(Polynomial());
+            mPendingSums.push_back(std::move(sum));
+        }
+
+        // Снять со стека слагаемое и добавить его с множителем factor в отложенную сумму
+        void appendTerm(PendingSum& sum, double factor)
+        {
+            if (isPendingSumOnTop())
+            {
+                PendingSum other = popPendingSum();
+                for (auto& term : other.terms)
+                {
+                    sum.terms.emplace_back(factor * term.first, std::move(term.second));
+                }
+            } else
+            {
+                sum.terms.emplace_back(factor, getPolynomialOp());
+            }
+        }
 
         double getDoubleOp()
         {
@@ -31,17 +111,22 @@ namespace Intr {
             }
         }
 
-        Polynomial getPolynomialOp()
+        PolynomialOperand getPolynomialOp()
         {
-            Op op = mOperands.top();
+            if (isPendingSumOnTop())
+            {
+                return { evaluatePendingSum(popPendingSum()), nullptr };
+            }
+
+            Op op = std::move(mOperands.top());
             mOperands.pop();
 
             if (std::holds_alternative<Polynomial>(op))
             {
-                return std::get<Polynomial>(op);
+                return { std::move(std::get<Polynomial>(op)), nullptr };
             } else if (std::holds_alternative<unsigned long>(op))
             {
-                return Polynomial(std::get<unsigned long>(op));
+                return { Polynomial(std::get<unsigned long>(op)), nullptr };
             } else if (std::holds_alternative<double>(op))
             {
                 double res = std::get<double>(op);
@@ -49,46 +134,111 @@ namespace Intr {
                 if (!isfinite(res))
                     throw "Overflow error occurred";
 
-                return Polynomial(res);
+                return { Polynomial(res), nullptr };
             } else if (std::holds_alternative<std::string>(op))
             {
-                auto p = pAggregator->findPolynomial(std::get<std::string>(op));
-                if (!p.has_value())
+                PolynomialHandle p = pAggregator->findPolynomial(std::get<std::string>(op));
+                if (!p)
                 {
                     throw "Polynomial with name \'" + std::get<std::string>(op) + "\' does not exist";
                 }
 
-                return p.value();
+                return { Polynomial(), std::move(p) };
             } else
             {
                 throw std::runtime_error(__FUNCTION__ ": unknown operand type.");
             }
         }
 
+        void addScaled(double factor)
+        {
+            PendingSum right;
+            appendTerm(right, factor);
+
+            if (isPendingSumOnTop())
+            {
+                // левый операнд уже отложенная сумма - дописываем в нее, не трогая стек
+                auto& terms = mPendingSums.back().terms;
+                for (auto& term : right.terms)
+                {
+                    terms.push_back(std::move(term));
+                }
+                return;
+            }
+
+            PendingSum sum;
+            sum.terms.emplace_back(1.0, getPolynomialOp());
+            for (auto& term : right.terms)
+            {
+                sum.terms.push_back(std::move(term));
+            }
+
+            pushPendingSum(std::move(sum));
+        }
+
         void add()
         {
-            Polynomial p1 = getPolynomialOp();
-            Polynomial p2 = getPolynomialOp();
-            mOperands.push(p2 + p1);
+            addScaled(1.0);
         }
 
         void subtract()
         {
-            Polynomial p1 = getPolynomialOp();
-            Polynomial p2 = getPolynomialOp();
-            mOperands.push(p2 - p1);
+            addScaled(-1.0);
         }
 
         void multiply()
         {
-            Polynomial p1 = getPolynomialOp();
-            Polynomial p2 = getPolynomialOp();
-            mOperands.push(p2 * p1);
+            PolynomialOperand p1 = getPolynomialOp();
+            PolynomialOperand p2 = getPolynomialOp();
+            mOperands.push(p2.get() * p1.get());
+        }
+
+        void power()
+        {
+            Op exponent = mOperands.top();
+            mOperands.pop();
+
+            if (!std::holds_alternative<unsigned long>(exponent))
+            {
+                throw std::runtime_error(__FUNCTION__ ": expected integer exponent.");
+            }
+
+            mOperands.push(getPolynomialOp().get().pow(std::get<unsigned long>(exponent)));
+        }
+
+        unsigned long getIntegerOp()
+        {
+            Op op = mOperands.top();
+            mOperands.pop();
+
+            if (!std::holds_alternative<unsigned long>(op))
+            {
+                throw "Degree bound and exponent must be non-negative integers";
+            }
+
+            return std::get<unsigned long>(op);
+        }
+
+        // truncmul(p1, p2, d): произведение без мономов полной степени больше d
+        void truncMultiply()
+        {
+            unsigned long maxTotalDegree = getIntegerOp();
+            PolynomialOperand p2 = getPolynomialOp();
+            PolynomialOperand p1 = getPolynomialOp();
+            mOperands.push(p1.get().mulTruncated(p2.get(), maxTotalDegree));
+        }
+
+        // truncpow(p, n, d): степень p^n без мономов полной степени больше d
+        void truncPower()
+        {
+            unsigned long maxTotalDegree = getIntegerOp();
+            unsigned long exponent = getIntegerOp();
+            mOperands.push(getPolynomialOp().get().powTruncated(exponent, maxTotalDegree));
         }
 
         void assign()
         {
-            Polynomial p = getPolynomialOp();
+            PolynomialOperand p = getPolynomialOp();
 
             Op name = mOperands.top();
             mOperands.pop();
@@ -98,18 +248,37 @@ namespace Intr {
                 throw std::runtime_error(__FUNCTION__ ": expected identifier.");
             }
 
-            mOperands.push(p);
-            pAggregator->addPolynomial(std::get<std::string>(name), p);
+            mOperands.push(p.get());
+
+            // сохраненный полином (a = b) разделяется таблицами без копирования
+            if (p.stored)
+            {
+                pAggregator->addPolynomial(std::get<std::string>(name), p.stored);
+                return;
+            }
+
+            // таблицы хранят полином дольше, чем живет память вычисления
+            MemoryResourceScope persistent(mpPersistentResource);
+            pAggregator->addPolynomial(std::get<std::string>(name), p.get());
         }
 
         void negate()
         {
-            Op op = mOperands.top();
+            if (isPendingSumOnTop())
+            {
+                for (auto& term : mPendingSums.back().terms)
+                {
+                    term.first = -term.first;
+                }
+                return;
+            }
+
+            Op op = std::move(mOperands.top());
             mOperands.pop();
 
             if (std::holds_alternative<Polynomial>(op))
             {
-                mOperands.push(-std::get<Polynomial>(op));
+                mOperands.push(-std::move(std::get<Polynomial>(op)));
             } else if (std::holds_alternative<unsigned long>(op))
             {
                 mOperands.push(-(double)std::get<unsigned long>(op));
@@ -118,13 +287,13 @@ namespace Intr {
                 mOperands.push(-std::get<double>(op));
             } else if (std::holds_alternative<std::string>(op))
             {
-                auto p = pAggregator->findPolynomial(std::get<std::string>(op));
-                if (!p.has_value())
+                PolynomialHandle p = pAggregator->findPolynomial(std::get<std::string>(op));
+                if (!p)
                 {
                     throw "Polynomial with name \'" + std::get<std::string>(op) + "\' does not exist";
                 }
 
-                mOperands.push(-p.value());
+                mOperands.push(-*p);
             } else
             {
                 throw std::runtime_error(__FUNCTION__ ": unknown operand type.");
@@ -137,52 +306,77 @@ namespace Intr {
             double y = getDoubleOp();
             double x = getDoubleOp();
             double w = getDoubleOp();
-            Polynomial p = getPolynomialOp();
-            mOperands.push(p.evaluate(w, x, y, z));
+            PolynomialOperand p = getPolynomialOp();
+            mOperands.push(p.get().evaluate(w, x, y, z));
+        }
+
+        // Вычисленный операнд изменяется на месте, а найденный в таблице - нет: производная
+        // строится сразу из него, без промежуточной копии
+        void differentiate(unsigned var)
+        {
+            PolynomialOperand p = getPolynomialOp();
+            if (p.stored)
+            {
+                mOperands.push(p.stored->derivative(var));
+                return;
+            }
+
+            p.value.differentiate(var);
+            mOperands.push(std::move(p.value));
+        }
+
+        void integrate(unsigned var)
+        {
+            Polynomial p = getPolynomialOp().take();
+            p.integrate(var);
+            mOperands.push(std::move(p));
         }
 
         void derx()
         {
-            mOperands.push(getPolynomialOp().derivativeX());
+            differentiate(1);
         }
 
         void dery()
         {
-            mOperands.push(getPolynomialOp().derivativeY());
+            differentiate(2);
         }
 
         void derz()
         {
-            mOperands.push(getPolynomialOp().derivativeZ());
+            differentiate(3);
         }
 
         void derw()
         {
-            mOperands.push(getPolynomialOp().derivativeW());
+            differentiate(0);
         }
 
         void intx()
         {
-            mOperands.push(getPolynomialOp().integralX());
+            integrate(1);
         }
 
         void inty()
         {
-            mOperands.push(getPolynomialOp().integralY());
+            integrate(2);
         }
 
         void intz()
         {
-            mOperands.push(getPolynomialOp().integralZ());
+            integrate(3);
         }
 
         void intw()
         {
-            mOperands.push(getPolynomialOp().integralW());
+            integrate(0);
         }
 
     public:
-        VirtualMachine(Aggregator* aggregator) : pAggregator(aggregator) {}
+        VirtualMachine(Aggregator* aggregator, std::pmr::memory_resource* persistentResource) :
+            pAggregator(aggregator), mpPersistentResource(persistentResource)
+        {
+        }
 
         void execOp(const Op& op)
         {
@@ -198,6 +392,7 @@ namespace Intr {
             case Opcode::ADD: add(); break;
             case Opcode::SUBTRACT: subtract(); break;
             case Opcode::MULT: multiply(); break;
+            case Opcode::POWER: power(); break;
             case Opcode::UMINUS: negate(); break;
             case Opcode::ASSIGN: assign(); break;
             case Opcode::CALC: calc(); break;
@@ -209,25 +404,41 @@ namespace Intr {
             case Opcode::INTY: inty(); break;
             case Opcode::INTZ: intz(); break;
             case Opcode::INTW: intw(); break;
+            case Opcode::TRUNCMUL: truncMultiply(); break;
+            case Opcode::TRUNCPOW: truncPower(); break;
             default: throw std::runtime_error(__FUNCTION__ ": operation is not supported.");
             }
         }
 
         Polynomial getResult()
         {
-            return getPolynomialOp();
+            return getPolynomialOp().take();
         }
     };
 
+    // Начальный буфер арены вычисления на стеке: небольшим выражениям хватает его без обращений к куче
+    const size_t EvaluationArenaBufferSize = 16 * 1024;
+
     std::variant<Polynomial, std::string> ExpressionInterpreter::execute(const Program& program)
     {
-        VirtualMachine vm(mpAggregator);
+        // Все промежуточные полиномы и стек операндов размещаются в монотонной арене, которая
+        // освобождается целиком после вычисления. Результат копируется в память вызывающего
+        Polynomial result;
 
-        for (size_t i = 0; i < program.size(); ++i)
+        std::byte buffer[EvaluationArenaBufferSize];
+        std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), currentMemoryResource());
         {
-            vm.execOp(program[i]);
+            MemoryResourceScope scope(&arena);
+            VirtualMachine vm(mpAggregator, scope.previous());
+
+            for (size_t i = 0; i < program.size(); ++i)
+            {
+                vm.execOp(program[i]);
+            }
+
+            result = vm.getResult();
         }
 
-        return vm.getResult();
+        return result;
     }
 }
\ No newline at end of file
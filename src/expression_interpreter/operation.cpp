@@ -19,6 +19,8 @@ namespace Intr {
         case Opcode::MULT: return "Opcode::MULT";
         case Opcode::POWER: return "Opcode::POWER";
         case Opcode::SUBTRACT: return "Opcode::SUBTRACT";
+        case Opcode::TRUNCMUL: return "Opcode::TRUNCMUL";
+        case Opcode::TRUNCPOW: return "Opcode::TRUNCPOW";
         case Opcode::UMINUS: return "Opcode::UMINUS";
         default: return "UNKNOWN";
         }
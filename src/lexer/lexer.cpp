@@ -26,6 +26,8 @@ namespace Lexer {
         { "inty", TokenType::INTY },
         { "intz", TokenType::INTZ },
         { "intw", TokenType::INTW },
+        { "truncmul", TokenType::TRUNCMUL },
+        { "truncpow", TokenType::TRUNCPOW },
     };
 
     void Lexer::generateTokens()
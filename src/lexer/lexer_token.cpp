@@ -25,6 +25,8 @@ namespace Lexer {
         case TokenType::INTY: return "TokenType::INTY";
         case TokenType::INTZ: return "TokenType::INTZ";
         case TokenType::INTW: return "TokenType::INTW";
+        case TokenType::TRUNCMUL: return "TokenType::TRUNCMUL";
+        case TokenType::TRUNCPOW: return "TokenType::TRUNCPOW";
         case TokenType::PLUS: return "TokenType::PLUS";
         case TokenType::MINUS: return "TokenType::MINUS";
         case TokenType::MULT: return "TokenType::MULT";
@@ -0,0 +1,73 @@
+#include "modular.h"
+#include "small_vector.h"
+#include <stdexcept>
+
+CrtReconstructor::CrtReconstructor(const std::vector<uint64_t>& moduli)
+{
+    if (moduli.empty())
+    {
+        throw std::invalid_argument(__FUNCTION__ ": at least one modulus is required.");
+    }
+
+    mContexts.reserve(moduli.size());
+    mLowerModuli.resize(moduli.size());
+    mPrefixInverses.resize(moduli.size());
+
+    for (size_t i = 0; i < moduli.size(); ++i)
+    {
+        const uint64_t m = moduli[i];
+        if (m % 2 == 0 || m < 3 || m >= (uint64_t(1) << 62))
+        {
+            throw std::invalid_argument(__FUNCTION__ ": moduli must be odd primes below 2^62.");
+        }
+
+        const Montgomery& context = mContexts.emplace_back(m);
+        uint64_t prefix = context.one();
+        for (size_t j = 0; j < i; ++j)
+        {
+            const uint64_t lower = context.toMontgomery(moduli[j]);
+            if (lower == 0)
+            {
+                throw std::invalid_argument(__FUNCTION__ ": moduli must be distinct.");
+            }
+            mLowerModuli[i].push_back(lower);
+            prefix = context.multiply(prefix, lower);
+        }
+
+        // модуль простой, поэтому обратный элемент вычисляется по малой теореме Ферма
+        mPrefixInverses[i] = context.pow(prefix, m - 2);
+    }
+}
+
+double CrtReconstructor::reconstruct(const uint64_t* residues) const
+{
+    SmallVector<int64_t, 4> digits;
+    digits.resize(mContexts.size());
+
+    for (size_t i = 0; i < mContexts.size(); ++i)
+    {
+        const Montgomery& context = mContexts[i];
+        const uint64_t m = context.modulus();
+
+        // уже найденная часть d0 + m0 * (d1 + ...) по модулю mi, схемой Горнера со старшей цифры
+        uint64_t known = 0;
+        for (size_t j = i; j-- > 0;)
+        {
+            const int64_t d = digits[j];
+            const uint64_t digit = d < 0 ? context.subtract(0, context.toMontgomery(0 - static_cast<uint64_t>(d)))
+                                         : context.toMontgomery(static_cast<uint64_t>(d));
+            known = context.add(context.multiply(known, mLowerModuli[i][j]), digit);
+        }
+
+        const uint64_t difference = context.subtract(context.toMontgomery(residues[i]), known);
+        const uint64_t digit = context.fromMontgomery(context.multiply(difference, mPrefixInverses[i]));
+        digits[i] = digit > m / 2 ? -static_cast<int64_t>(m - digit) : static_cast<int64_t>(digit);
+    }
+
+    double result = 0.0;
+    for (size_t i = mContexts.size(); i-- > 0;)
+    {
+        result = result * static_cast<double>(mContexts[i].modulus()) + static_cast<double>(digits[i]);
+    }
+    return result;
+}
@@ -0,0 +1,137 @@
+#include "ntt.h"
+#include <stdexcept>
+
+namespace Ntt {
+
+    // Простые вида c * 2^k + 1 с первообразным корнем 3. Произведение модулей ~7.9e16 > 2^56
+    const uint64_t Mod1 = 167772161; // 5 * 2^25 + 1
+    const uint64_t Mod2 = 469762049; // 7 * 2^26 + 1
+    const uint64_t PrimitiveRoot = 3;
+
+    uint64_t powMod(uint64_t base, uint64_t exp, uint64_t mod)
+    {
+        uint64_t res = 1;
+        base %= mod;
+        while (exp)
+        {
+            if (exp & 1) res = res * base % mod;
+            base = base * base % mod;
+            exp >>= 1;
+        }
+        return res;
+    }
+
+    void transform(std::vector<uint32_t>& a, uint64_t mod, bool inverse)
+    {
+        const size_t n = a.size();
+
+        for (size_t i = 1, j = 0; i < n; ++i)
+        {
+            size_t bit = n >> 1;
+            for (; j & bit; bit >>= 1) j ^= bit;
+            j ^= bit;
+            if (i < j) std::swap(a[i], a[j]);
+        }
+
+        std::vector<uint32_t> roots(n / 2 + 1);
+        for (size_t len = 2; len <= n; len <<= 1)
+        {
+            uint64_t root = powMod(PrimitiveRoot, (mod - 1) / len, mod);
+            if (inverse) root = powMod(root, mod - 2, mod);
+
+            const size_t half = len / 2;
+            roots[0] = 1;
+            for (size_t k = 1; k < half; ++k)
+            {
+                roots[k] = static_cast<uint32_t>(roots[k - 1] * root % mod);
+            }
+
+            for (size_t i = 0; i < n; i += len)
+            {
+                for (size_t k = 0; k < half; ++k)
+                {
+                    uint64_t u = a[i + k];
+                    uint64_t v = a[i + k + half] * static_cast<uint64_t>(roots[k]) % mod;
+                    a[i + k] = static_cast<uint32_t>(u + v < mod ? u + v : u + v - mod);
+                    a[i + k + half] = static_cast<uint32_t>(u >= v ? u - v : u + mod - v);
+                }
+            }
+        }
+
+        if (inverse)
+        {
+            uint64_t invN = powMod(n, mod - 2, mod);
+            for (auto& v : a)
+            {
+                v = static_cast<uint32_t>(v * invN % mod);
+            }
+        }
+    }
+
+    std::vector<uint32_t> convolveMod(const std::vector<int64_t>& a, const std::vector<int64_t>& b, size_t n, uint64_t mod)
+    {
+        auto reduce = [mod](int64_t v)
+        {
+            int64_t r = v % static_cast<int64_t>(mod);
+            return static_cast<uint32_t>(r < 0 ? r + static_cast<int64_t>(mod) : r);
+        };
+
+        std::vector<uint32_t> fa(n, 0);
+        for (size_t i = 0; i < a.size(); ++i) fa[i] = reduce(a[i]);
+        transform(fa, mod, false);
+
+        if (&a == &b)
+        {
+            // квадрат: достаточно одного прямого преобразования
+            for (size_t i = 0; i < n; ++i)
+            {
+                fa[i] = static_cast<uint32_t>(static_cast<uint64_t>(fa[i]) * fa[i] % mod);
+            }
+        } else
+        {
+            std::vector<uint32_t> fb(n, 0);
+            for (size_t i = 0; i < b.size(); ++i) fb[i] = reduce(b[i]);
+            transform(fb, mod, false);
+
+            for (size_t i = 0; i < n; ++i)
+            {
+                fa[i] = static_cast<uint32_t>(static_cast<uint64_t>(fa[i]) * fb[i] % mod);
+            }
+        }
+        transform(fa, mod, true);
+
+        return fa;
+    }
+
+    std::vector<int64_t> convolve(const std::vector<int64_t>& a, const std::vector<int64_t>& b)
+    {
+        if (a.empty() || b.empty()) return {};
+
+        const size_t resultLength = a.size() + b.size() - 1;
+        size_t n = 1;
+        while (n < resultLength) n <<= 1;
+
+        if (n > MaxConvolutionLength)
+        {
+            throw std::length_error(__FUNCTION__ ": convolution is too long.");
+        }
+
+        std::vector<uint32_t> r1 = convolveMod(a, b, n, Mod1);
+        std::vector<uint32_t> r2 = convolveMod(a, b, n, Mod2);
+
+        // Алгоритм Гарнера: x = r1 + Mod1 * ((r2 - r1) * Mod1^-1 mod Mod2), 0 <= x < Mod1 * Mod2
+        const uint64_t mod1InvMod2 = powMod(Mod1, Mod2 - 2, Mod2);
+        const uint64_t fullMod = Mod1 * Mod2;
+
+        std::vector<int64_t> res(resultLength);
+        for (size_t i = 0; i < resultLength; ++i)
+        {
+            uint64_t d2 = (r2[i] + Mod2 - r1[i] % Mod2) % Mod2 * mod1InvMod2 % Mod2;
+            uint64_t x = r1[i] + Mod1 * d2;
+            // Значения больше половины модуля соответствуют отрицательным числам
+            res[i] = x > fullMod / 2 ? -static_cast<int64_t>(fullMod - x) : static_cast<int64_t>(x);
+        }
+
+        return res;
+    }
+}
\ No newline at end of file
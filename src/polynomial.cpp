@@ -1,497 +1,2614 @@
 #include "polynomial.h"
+#include "ntt.h"
+#include "thread_pool.h"
+#include <cctype>
+#include <charconv>
 #include <cmath>
+#include <cstring>
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
 #include <algorithm>
+#include <functional>
 #include <map>
+#include <memory>
+#include <mutex>
+#include <utility>
 #include <vector>
 
-Polynomial Polynomial::operator+(const Polynomial& other) const
+// Полином хранится в плотной форме, если мономы занимают не меньше DenseFormFillThreshold ячеек
+// прямоугольной области степеней: ячейка плотной формы занимает 8 байт, а моном разреженной - 16,
+// поэтому при таком заполнении плотная форма не больше разреженной. Маленькие полиномы
+// (область меньше MinDenseFormVolume ячеек) всегда разреженные
+const double DenseFormFillThreshold = 0.5;
+const double MinDenseFormVolume = 16;
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::sparseCopy() const
+{
+    if (!isDense()) return *this;
+
+    BasicPolynomial res;
+    res.reserve(size());
+    forEachTerm([&res](uint64_t degree, Coefficient coefficient)
+    {
+        res.pushBack(degree, coefficient);
+        return true;
+    });
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+const BasicPolynomial<NVars, Bits, Coefficient>& BasicPolynomial<NVars, Bits, Coefficient>::sparseForm(const BasicPolynomial& p, BasicPolynomial& storage)
+{
+    if (!p.isDense()) return p;
+
+    storage = p.sparseCopy();
+    return storage;
+}
+
+// Преобразования формы не меняют мономов, поэтому схема вычисления остается верной.
+// Новые массивы берут память из того же ресурса, что и прежние
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::makeSparse()
+{
+    if (!isDense()) return;
+
+    MemoryResourceScope scope(mCoefficients.resource());
+    BasicPolynomial sparse = sparseCopy();
+    mDegrees = std::move(sparse.mDegrees);
+    mCoefficients = std::move(sparse.mCoefficients);
+    mBox = DenseBox();
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::makeDense(const DegreeBounds& bounds)
+{
+    DenseBox box;
+    size_t strides[NVars];
+    size_t volume = 1;
+    for (unsigned var = NVars; var-- > 0;)
+    {
+        box.extent[var] = bounds.max[var] - bounds.min[var] + 1;
+        strides[var] = volume;
+        volume *= box.extent[var];
+    }
+    Exponents top;
+    std::copy(bounds.max, bounds.max + NVars, top.begin());
+    box.top = packDegree(top);
+    box.terms = mDegrees.size();
+
+    MemoryResourceScope scope(mCoefficients.resource());
+    SmallVector<Coefficient, InlineMonomials> cells;
+    cells.resize(volume, Coefficient());
+    for (size_t i = 0; i < mDegrees.size(); ++i)
+    {
+        size_t index = 0;
+        for (unsigned var = 0; var < NVars; ++var)
+        {
+            index += (bounds.max[var] - variableDegree(mDegrees[i], var)) * strides[var];
+        }
+        cells[index] = mCoefficients[i];
+    }
+
+    mCoefficients = std::move(cells);
+    mDegrees = SmallVector<uint64_t, InlineMonomials>();
+    mBox = box;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::chooseRepresentation()
+{
+    makeSparse();
+    if (static_cast<double>(size()) < DenseFormFillThreshold * MinDenseFormVolume) return;
+
+    const DegreeBounds bounds = degreeBounds();
+    double volume = 1.0;
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        volume *= static_cast<double>(bounds.max[var] - bounds.min[var]) + 1.0;
+    }
+
+    if (volume >= MinDenseFormVolume && static_cast<double>(size()) >= DenseFormFillThreshold * volume)
+    {
+        makeDense(bounds);
+    }
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::countTerms() noexcept
+{
+    mBox.terms = static_cast<size_t>(std::count_if(mCoefficients.begin(), mCoefficients.end(),
+        [](Coefficient c) { return c != Coefficient(); }));
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+bool BasicPolynomial<NVars, Bits, Coefficient>::addBox(BasicPolynomial& target, const BasicPolynomial& p, Coefficient factor)
+{
+    // смещение области p относительно области target по каждой переменной
+    uint32_t shift[NVars];
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        const uint32_t top = variableDegree(target.mBox.top, var);
+        const uint32_t pTop = variableDegree(p.mBox.top, var);
+        if (pTop > top || top - pTop + p.mBox.extent[var] > target.mBox.extent[var]) return false;
+        shift[var] = top - pTop;
+    }
+
+    size_t strides[NVars];
+    size_t stride = 1;
+    for (unsigned var = NVars; var-- > 0;)
+    {
+        strides[var] = stride;
+        stride *= target.mBox.extent[var];
+    }
+
+    // строки последней переменной лежат подряд в обеих областях
+    const uint32_t rowLength = p.mBox.extent[NVars - 1];
+    uint32_t digits[NVars] = {};
+    for (size_t source = 0; source < p.mCoefficients.size(); source += rowLength)
+    {
+        size_t index = 0;
+        for (unsigned var = 0; var < NVars; ++var)
+        {
+            index += (shift[var] + digits[var]) * strides[var];
+        }
+        for (uint32_t k = 0; k < rowLength; ++k)
+        {
+            target.mCoefficients[index + k] += factor * p.mCoefficients[source + k];
+        }
+
+        for (unsigned var = NVars - 1; var-- > 0;)
+        {
+            if (++digits[var] < p.mBox.extent[var]) break;
+            digits[var] = 0;
+        }
+    }
+
+    return true;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::mergeDense(const BasicPolynomial& a, const BasicPolynomial& b, Coefficient factor)
+{
+    // Сумма считается в плотной форме в объединении областей, если оно заполнено достаточно
+    // даже без сокращений; иначе слагаемые сливаются в разреженной форме
+    Exponents top;
+    DenseBox box;
+    double volume = 1.0;
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        const uint32_t topA = variableDegree(a.mBox.top, var);
+        const uint32_t topB = variableDegree(b.mBox.top, var);
+        const uint32_t low = std::min(topA - (a.mBox.extent[var] - 1), topB - (b.mBox.extent[var] - 1));
+        top[var] = std::max(topA, topB);
+        box.extent[var] = top[var] - low + 1;
+        volume *= static_cast<double>(box.extent[var]);
+    }
+    box.top = packDegree(top);
+
+    if (static_cast<double>(a.size() + b.size()) < DenseFormFillThreshold * volume)
+    {
+        BasicPolynomial res = mergeScaled(a.sparseCopy(), b.sparseCopy(), factor);
+        res.chooseRepresentation();
+        return res;
+    }
+
+    BasicPolynomial res;
+    res.mBox = box;
+    res.mCoefficients.resize(static_cast<size_t>(volume), Coefficient());
+    addBox(res, a, Coefficient(1));
+    addBox(res, b, factor);
+    res.countTerms();
+
+    if (static_cast<double>(res.size()) < DenseFormFillThreshold * volume)
+    {
+        res.chooseRepresentation();
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::mergeScaled(const BasicPolynomial& a, const BasicPolynomial& b, Coefficient factor)
+{
+    if (a.isDense() && b.isDense()) return mergeDense(a, b, factor);
+    if (a.isDense() || b.isDense())
+    {
+        BasicPolynomial sparseA, sparseB;
+        return mergeScaled(sparseForm(a, sparseA), sparseForm(b, sparseB), factor);
+    }
+
+    BasicPolynomial result;
+    result.reserve(a.size() + b.size());
+
+    const size_t n1 = a.size();
+    const size_t n2 = b.size();
+    size_t i1 = 0;
+    size_t i2 = 0;
+
+    while (i1 < n1 && i2 < n2)
+    {
+        uint64_t deg1 = a.mDegrees[i1];
+        uint64_t deg2 = b.mDegrees[i2];
+
+        if (deg1 > deg2)
+        {
+            result.pushBack(deg1, a.mCoefficients[i1]);
+            ++i1;
+        } else if (deg2 > deg1)
+        {
+            result.pushBack(deg2, factor * b.mCoefficients[i2]);
+            ++i2;
+        } else
+        {
+            Coefficient coefficient = a.mCoefficients[i1] + factor * b.mCoefficients[i2];
+            if (coefficient != Coefficient())
+            {
+                result.pushBack(deg1, coefficient);
+            }
+            ++i1;
+            ++i2;
+        }
+    }
+
+    result.mDegrees.insert(result.mDegrees.end(), a.mDegrees.begin() + i1, a.mDegrees.end());
+    result.mCoefficients.insert(result.mCoefficients.end(), a.mCoefficients.begin() + i1, a.mCoefficients.end());
+    result.mDegrees.insert(result.mDegrees.end(), b.mDegrees.begin() + i2, b.mDegrees.end());
+    for (; i2 < n2; ++i2)
+    {
+        result.mCoefficients.push_back(factor * b.mCoefficients[i2]);
+    }
+
+    return result;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::mergeScaledInPlace(const BasicPolynomial& other, Coefficient factor)
+{
+    if (&other == this)
+    {
+        *this *= Coefficient(1) + factor;
+        return;
+    }
+
+    if (other.size() == 0) return;
+
+    if (isDense() && other.isDense())
+    {
+        invalidateEvaluationPlan();
+        if (addBox(*this, other, factor))
+        {
+            countTerms();
+            if (static_cast<double>(size()) < DenseFormFillThreshold * static_cast<double>(mCoefficients.size()))
+            {
+                chooseRepresentation();
+            }
+        } else
+        {
+            *this = mergeDense(*this, other, factor);
+        }
+        return;
+    }
+    if (other.isDense())
+    {
+        mergeScaledInPlace(other.sparseCopy(), factor);
+        return;
+    }
+    makeSparse();
+
+    const size_t n = size();
+    const size_t m = other.size();
+
+    invalidateEvaluationPlan();
+
+    // Слияние с конца: массивы расширяются на m элементов, и мономы записываются от меньших степеней
+    // к большим, начиная с последней позиции. Позиция записи никогда не обгоняет позицию чтения
+    // собственных мономов, поэтому дополнительный буфер не нужен. Сократившиеся мономы оставляют
+    // пустые места в начале массивов, которые удаляются одним сдвигом в конце
+    mDegrees.resize(n + m);
+    mCoefficients.resize(n + m);
+
+    size_t i = n;     // число еще не обработанных собственных мономов
+    size_t j = m;     // число еще не обработанных мономов other
+    size_t k = n + m; // позиция записи (не включительно)
+
+    while (i > 0 && j > 0)
+    {
+        const uint64_t deg1 = mDegrees[i - 1];
+        const uint64_t deg2 = other.mDegrees[j - 1];
+
+        if (deg1 < deg2)
+        {
+            --k;
+            mDegrees[k] = deg1;
+            mCoefficients[k] = mCoefficients[i - 1];
+            --i;
+        } else if (deg2 < deg1)
+        {
+            --k;
+            mDegrees[k] = deg2;
+            mCoefficients[k] = factor * other.mCoefficients[j - 1];
+            --j;
+        } else
+        {
+            Coefficient coefficient = mCoefficients[i - 1] + factor * other.mCoefficients[j - 1];
+            if (coefficient != Coefficient())
+            {
+                --k;
+                mDegrees[k] = deg1;
+                mCoefficients[k] = coefficient;
+            }
+            --i;
+            --j;
+        }
+    }
+
+    while (j > 0)
+    {
+        --k;
+        mDegrees[k] = other.mDegrees[j - 1];
+        mCoefficients[k] = factor * other.mCoefficients[j - 1];
+        --j;
+    }
+
+    if (k != i)
+    {
+        // оставшиеся собственные мономы [0, i) сдвигаются вплотную к записанным
+        std::copy_backward(mDegrees.begin(), mDegrees.begin() + i, mDegrees.begin() + k);
+        std::copy_backward(mCoefficients.begin(), mCoefficients.begin() + i, mCoefficients.begin() + k);
+        k -= i;
+        mDegrees.erase(mDegrees.begin(), mDegrees.begin() + k);
+        mCoefficients.erase(mCoefficients.begin(), mCoefficients.begin() + k);
+    }
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::linearCombination(const std::vector<ScaledPolynomial>& terms)
+{
+    struct Stream
+    {
+        Coefficient factor;
+        const BasicPolynomial* polynomial;
+        size_t position;
+    };
+
+    std::vector<Stream> streams;
+    streams.reserve(terms.size());
+    std::vector<BasicPolynomial> sparseCopies; // слагаемые в плотной форме сливаются по разреженным копиям
+    sparseCopies.reserve(terms.size());
+    size_t totalSize = 0;
+    for (const ScaledPolynomial& term : terms)
+    {
+        const BasicPolynomial& p = term.second.get();
+        if (term.first != Coefficient() && p.size() != 0)
+        {
+            if (p.isDense())
+            {
+                sparseCopies.push_back(p.sparseCopy());
+            }
+            streams.push_back({ term.first, p.isDense() ? &sparseCopies.back() : &p, 0 });
+            totalSize += p.size();
+        }
+    }
+
+    if (streams.empty()) return BasicPolynomial();
+    if (streams.size() == 1) return (*streams[0].polynomial) * streams[0].factor;
+
+    // k-путевое слияние: в max-куче лежит по одному текущему моному на каждое слагаемое
+    struct HeapEntry
+    {
+        uint64_t degree;
+        size_t stream;
+        bool operator<(const HeapEntry& other) const noexcept { return degree < other.degree; }
+    };
+
+    std::vector<HeapEntry> heap;
+    heap.reserve(streams.size());
+    for (size_t i = 0; i < streams.size(); ++i)
+    {
+        heap.push_back({ streams[i].polynomial->mDegrees[0], i });
+    }
+    std::make_heap(heap.begin(), heap.end());
+
+    BasicPolynomial result;
+    result.reserve(totalSize);
+
+    while (!heap.empty())
+    {
+        const uint64_t degree = heap.front().degree;
+        Coefficient coefficient = Coefficient();
+
+        while (!heap.empty() && heap.front().degree == degree)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            Stream& stream = streams[heap.back().stream];
+            coefficient += stream.factor * stream.polynomial->mCoefficients[stream.position];
+
+            if (++stream.position < stream.polynomial->size())
+            {
+                heap.back().degree = stream.polynomial->mDegrees[stream.position];
+                std::push_heap(heap.begin(), heap.end());
+            } else
+            {
+                heap.pop_back();
+            }
+        }
+
+        if (coefficient != Coefficient())
+        {
+            result.pushBack(degree, coefficient);
+        }
+    }
+
+    return result;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator+(const BasicPolynomial& other) const&
+{
+    return mergeScaled(*this, other, Coefficient(1));
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator+(const BasicPolynomial& other) &&
+{
+    *this += other;
+    return std::move(*this);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator+(BasicPolynomial&& other) const&
+{
+    other += *this;
+    return std::move(other);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator+(BasicPolynomial&& other) &&
+{
+    *this += other;
+    return std::move(*this);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator-(const BasicPolynomial& other) const&
+{
+    return mergeScaled(*this, other, Coefficient(-1));
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator-(const BasicPolynomial& other) &&
+{
+    *this -= other;
+    return std::move(*this);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator-(BasicPolynomial&& other) const&
+{
+    other.negate();
+    other += *this;
+    return std::move(other);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator-(BasicPolynomial&& other) &&
+{
+    *this -= other;
+    return std::move(*this);
+}
+
+// Плотное умножение выбирается, если число пар мономов больше DenseMultiplicationThreshold * L log L,
+// где L - длина плотного представления произведения
+const double DenseMultiplicationThreshold = 0.5;
+// Наибольшее целое, до которого все целые числа точно представимы в double
+const double MaxExactInteger = 9007199254740992.0; // 2^53
+// Минимальное число пар мономов, начиная с которого умножение распределяется по потокам
+const double ParallelMultiplicationThreshold = 1 << 18;
+// Стоимости хеш-умножения в единицах одного шага просеивания кучи (подобраны по замерам): вставка пары
+// мономов, пока таблица помещается в кэш, вставка в большую таблицу и одно сравнение при сортировке
+const double HashInsertCost = 1.0;
+const double HashMissInsertCost = 4.0;
+const double HashSortCost = 0.5;
+// Число различных степеней, до которого таблица (около 24 байт на степень) помещается в кэш L2
+const double HashCacheEntries = 1 << 15;
+// Наибольшее число различных степеней, для которого произведение накапливается в хеш-таблице
+const double MaxHashEntries = 1 << 22;
+
+namespace
+{
+    // Число потоков умножения и пул потоков общие для всех конфигураций полиномов
+    std::atomic<unsigned> sMultiplicationThreads = 1;
+
+    ThreadPool& multiplicationPool()
+    {
+        static ThreadPool pool(std::max(1u, std::thread::hardware_concurrency()));
+        return pool;
+    }
+
+    // Накопление произведений мономов в таблице с открытой адресацией (линейное пробирование),
+    // ключ - упакованная степень. Таблица хранит номера накопленных мономов, сами мономы лежат
+    // подряд в массиве и один раз сортируются в конце. expectedSize - оценка сверху числа различных
+    // степеней, поэтому таблица заполнена не больше чем наполовину и не перестраивается
+    template <typename Coefficient>
+    class ProductAccumulator
+    {
+    public:
+        explicit ProductAccumulator(size_t expectedSize)
+        {
+            while ((size_t(1) << mCapacityBits) < 2 * expectedSize) ++mCapacityBits;
+            mMask = (size_t(1) << mCapacityBits) - 1;
+            mSlots.assign(mMask + 1, 0);
+            mTerms.reserve(expectedSize);
+        }
+
+        void add(uint64_t degree, Coefficient product)
+        {
+            // фибоначчиево хеширование: старшие биты произведения на 2^64 / phi
+            size_t slot = static_cast<size_t>((degree * 0x9E3779B97F4A7C15ull) >> (64 - mCapacityBits));
+            while (true)
+            {
+                const uint32_t index = mSlots[slot];
+                if (index == 0)
+                {
+                    mTerms.emplace_back(degree, product);
+                    mSlots[slot] = static_cast<uint32_t>(mTerms.size());
+                    return;
+                }
+                if (mTerms[index - 1].first == degree)
+                {
+                    mTerms[index - 1].second += product;
+                    return;
+                }
+                slot = (slot + 1) & mMask;
+            }
+        }
+
+        // Накопленные мономы по убыванию степени
+        const std::vector<std::pair<uint64_t, Coefficient>>& sortedTerms()
+        {
+            std::sort(mTerms.begin(), mTerms.end(), [](const auto& lhs, const auto& rhs) { return lhs.first > rhs.first; });
+            return mTerms;
+        }
+
+    private:
+        unsigned mCapacityBits = 4;
+        size_t mMask;
+        std::vector<uint32_t> mSlots; // номер монома + 1, 0 - свободно
+        std::vector<std::pair<uint64_t, Coefficient>> mTerms;
+    };
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+typename BasicPolynomial<NVars, Bits, Coefficient>::DegreeBounds BasicPolynomial<NVars, Bits, Coefficient>::degreeBounds() const
+{
+    DegreeBounds bounds;
+    std::fill(bounds.min, bounds.min + NVars, MaxDegree);
+    std::fill(bounds.max, bounds.max + NVars, 0);
+
+    for (uint64_t degree : mDegrees)
+    {
+        for (unsigned var = 0; var < NVars; ++var)
+        {
+            const uint32_t d = variableDegree(degree, var);
+            bounds.min[var] = std::min(bounds.min[var], d);
+            bounds.max[var] = std::max(bounds.max[var], d);
+        }
+    }
+
+    return bounds;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+std::pair<uint64_t, uint64_t> BasicPolynomial<NVars, Bits, Coefficient>::totalDegreeRange() const
+{
+    uint64_t minTotal = UINT64_MAX;
+    uint64_t maxTotal = 0;
+    for (uint64_t degree : mDegrees)
+    {
+        const uint64_t total = totalDegree(degree);
+        minTotal = std::min(minTotal, total);
+        maxTotal = std::max(maxTotal, total);
+    }
+
+    return { minTotal, maxTotal };
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::checkMultiplicationOverflow(const DegreeBounds& a, const DegreeBounds& b)
+{
+    // Максимальная степень произведения по каждой переменной равна сумме максимальных степеней сомножителей,
+    // поэтому переполнение можно обнаружить один раз до умножения, а не на каждой паре мономов.
+    // Тогда внутренний цикл умножения - одно сложение упакованных степеней без проверок
+    Exponents maxA;
+    Exponents maxB;
+    std::copy(a.max, a.max + NVars, maxA.begin());
+    std::copy(b.max, b.max + NVars, maxB.begin());
+
+    if (degreeSumOverflows(packDegree(maxA), packDegree(maxB)))
+    {
+        throw "Overflow in multiplication occurred";
+    }
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyHeap(const BasicPolynomial& a, const BasicPolynomial& b)
+{
+    // Слияние n отсортированных потоков a[i] * b (метод Джонсона). В куче одновременно находится
+    // не более одного элемента на строку i, следующая строка добавляется, когда из кучи извлечен
+    // ее первый элемент a[i] * b[0]. Размер кучи не превышает a.size(), сложность O(nm log n).
+    struct HeapEntry
+    {
+        uint64_t degree;
+        uint32_t i;
+        uint32_t j;
+    };
+
+    BasicPolynomial res;
+    const size_t n = a.size();
+    const size_t m = b.size();
+    if (n == 0 || m == 0) return res;
+
+    res.reserve(n + m);
+
+    std::vector<HeapEntry> heap;
+    heap.reserve(n);
+
+    // max-куча по степени
+    auto siftUp = [&heap](size_t pos)
+    {
+        HeapEntry entry = heap[pos];
+        while (pos > 0)
+        {
+            size_t parent = (pos - 1) / 2;
+            if (heap[parent].degree >= entry.degree) break;
+            heap[pos] = heap[parent];
+            pos = parent;
+        }
+        heap[pos] = entry;
+    };
+
+    auto siftDown = [&heap](size_t pos)
+    {
+        const size_t count = heap.size();
+        HeapEntry entry = heap[pos];
+        while (2 * pos + 1 < count)
+        {
+            size_t child = 2 * pos + 1;
+            if (child + 1 < count && heap[child + 1].degree > heap[child].degree) ++child;
+            if (heap[child].degree <= entry.degree) break;
+            heap[pos] = heap[child];
+            pos = child;
+        }
+        heap[pos] = entry;
+    };
+
+    heap.push_back({ a.mDegrees[0] + b.mDegrees[0], 0, 0 });
+
+    while (!heap.empty())
+    {
+        const uint64_t degree = heap.front().degree;
+        Coefficient coefficient = Coefficient();
+
+        while (!heap.empty() && heap.front().degree == degree)
+        {
+            const HeapEntry top = heap.front();
+            coefficient += a.mCoefficients[top.i] * b.mCoefficients[top.j];
+
+            // следующий элемент той же строки замещает вершину кучи
+            if (top.j + 1 < m)
+            {
+                heap.front() = { a.mDegrees[top.i] + b.mDegrees[top.j + 1], top.i, top.j + 1 };
+            } else
+            {
+                heap.front() = heap.back();
+                heap.pop_back();
+            }
+            if (!heap.empty()) siftDown(0);
+
+            if (top.j == 0 && top.i + 1 < n)
+            {
+                heap.push_back({ a.mDegrees[top.i + 1] + b.mDegrees[0], top.i + 1, 0 });
+                siftUp(heap.size() - 1);
+            }
+        }
+
+        if (coefficient != Coefficient())
+        {
+            res.pushBack(degree, coefficient);
+        }
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyHash(const BasicPolynomial& a, const BasicPolynomial& b, size_t expectedSize)
+{
+    // Произведения всех пар складываются в ProductAccumulator. Для квадрата (a и b - один объект)
+    // пары (i, j) и (j, i) считаются один раз
+    const bool isSquare = &a == &b;
+    const size_t n = a.size();
+    const size_t m = b.size();
+
+    ProductAccumulator<Coefficient> accumulator(expectedSize);
+    for (size_t i = 0; i < n; ++i)
+    {
+        const uint64_t degreeA = a.mDegrees[i];
+        const Coefficient coefficientA = a.mCoefficients[i];
+        for (size_t j = isSquare ? i : 0; j < m; ++j)
+        {
+            Coefficient product = coefficientA * b.mCoefficients[j];
+            if (isSquare && j != i) product += product;
+            accumulator.add(degreeA + b.mDegrees[j], product);
+        }
+    }
+
+    const auto& terms = accumulator.sortedTerms();
+    BasicPolynomial res;
+    res.reserve(terms.size());
+    for (const auto& [degree, coefficient] : terms)
+    {
+        if (coefficient != Coefficient())
+        {
+            res.pushBack(degree, coefficient);
+        }
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::squareHeap(const BasicPolynomial& a)
+{
+    // a^2 = sum a[i]^2 * t^(2 e[i]) + 2 * sum_{i < j} a[i] * a[j] * t^(e[i] + e[j]). Слияние кучей, как
+    // в multiplyHeap, но строка i начинается с j = i, поэтому вычисляется вдвое меньше произведений.
+    // Голова строки i + 1 (2 e[i + 1]) меньше головы строки i, и строка добавляется, когда извлечена
+    // голова предыдущей
+    struct HeapEntry
+    {
+        uint64_t degree;
+        uint32_t i;
+        uint32_t j;
+
+        bool operator<(const HeapEntry& other) const noexcept { return degree < other.degree; }
+    };
+
+    BasicPolynomial res;
+    const size_t n = a.size();
+    if (n == 0) return res;
+
+    res.reserve(2 * n);
+
+    std::vector<HeapEntry> heap;
+    heap.reserve(n);
+    heap.push_back({ 2 * a.mDegrees[0], 0, 0 });
+
+    while (!heap.empty())
+    {
+        const uint64_t degree = heap.front().degree;
+        Coefficient coefficient = Coefficient();
+
+        while (!heap.empty() && heap.front().degree == degree)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            const HeapEntry top = heap.back();
+            heap.pop_back();
+
+            const Coefficient product = a.mCoefficients[top.i] * a.mCoefficients[top.j];
+            coefficient += top.i == top.j ? product : product + product;
+
+            if (top.j + 1 < n)
+            {
+                heap.push_back({ a.mDegrees[top.i] + a.mDegrees[top.j + 1], top.i, top.j + 1 });
+                std::push_heap(heap.begin(), heap.end());
+            }
+
+            if (top.j == top.i && top.i + 1 < n)
+            {
+                heap.push_back({ 2 * a.mDegrees[top.i + 1], top.i + 1, top.i + 1 });
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+
+        if (coefficient != Coefficient())
+        {
+            res.pushBack(degree, coefficient);
+        }
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+double BasicPolynomial<NVars, Bits, Coefficient>::productLength(const DegreeBounds& ba, const DegreeBounds& bb)
+{
+    double length = 1.0;
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        length *= static_cast<double>(static_cast<uint64_t>(ba.max[var] - ba.min[var]) + (bb.max[var] - bb.min[var]) + 1);
+    }
+
+    return length;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+double BasicPolynomial<NVars, Bits, Coefficient>::denseProductCost(const DegreeBounds& ba, const DegreeBounds& bb)
+{
+    const double length = productLength(ba, bb);
+    if (length > static_cast<double>(Ntt::MaxConvolutionLength)) return -1.0;
+
+    return DenseMultiplicationThreshold * length * std::log2(length + 1.0);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+bool BasicPolynomial<NVars, Bits, Coefficient>::isDenseProductProfitable(const BasicPolynomial& a, const DegreeBounds& ba, const BasicPolynomial& b, const DegreeBounds& bb)
+{
+    // Плотный путь точен только для целых коэффициентов, у которых любой коэффициент произведения
+    // (не больше min(n, m) * max|a| * max|b|) представим в double без потери точности
+    if constexpr (!IsFloatingPoint)
+    {
+        return false;
+    } else
+    {
+        auto maxAbsInteger = [](const BasicPolynomial& p)
+        {
+            double maxAbs = 0.0;
+            for (double c : p.mCoefficients)
+            {
+                if (c != std::trunc(c)) return -1.0;
+                maxAbs = std::max(maxAbs, std::fabs(c));
+            }
+            return maxAbs;
+        };
+
+        const double transformCost = denseProductCost(ba, bb);
+        if (transformCost < 0.0) return false;
+
+        const double pairs = static_cast<double>(a.size()) * static_cast<double>(b.size());
+        if (pairs < transformCost) return false;
+
+        const double maxA = maxAbsInteger(a);
+        const double maxB = maxAbsInteger(b);
+        if (maxA < 0.0 || maxB < 0.0) return false;
+
+        return static_cast<double>(std::min(a.size(), b.size())) * maxA * maxB < MaxExactInteger;
+    }
+}
+
+// Модель стоимости умножения. Плотная свертка выгодна, если пар мономов больше, чем L log L.
+// Слияние кучей тратит на каждую пару просеивание в куче из min(n, m) строк, а хеш-таблица -
+// одну вставку, но затем сортирует все различные степени произведения (их не больше min(n * m, L)).
+// Поэтому хеш-таблица выгоднее, когда много произведений попадает в одну степень (n * m >> L)
+// и оба сомножителя длинные, а куча - когда один сомножитель короткий или все произведения различны
+// и таблица не помещается в кэш
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+MultiplicationStrategy BasicPolynomial<NVars, Bits, Coefficient>::chooseMultiplication(const BasicPolynomial& a, const DegreeBounds& ba, const BasicPolynomial& b, const DegreeBounds& bb)
+{
+    if (a.size() == 1 || b.size() == 1) return MultiplicationStrategy::Monomial;
+
+    if constexpr (IsFloatingPoint)
+    {
+        if (isDenseProductProfitable(a, ba, b, bb)) return MultiplicationStrategy::Dense;
+    }
+
+    const double n = static_cast<double>(a.size());
+    const double m = static_cast<double>(b.size());
+    const double pairs = n * m;
+
+    const unsigned threadCount = multiplicationThreads();
+    if (threadCount > 1 && pairs >= ParallelMultiplicationThreshold) return MultiplicationStrategy::Parallel;
+
+    // у квадрата вычисляется только половина пар
+    const double computedPairs = &a == &b ? 0.5 * n * (n + 1.0) : pairs;
+    const double distinct = std::min(computedPairs, productLength(ba, bb));
+    if (distinct > MaxHashEntries) return MultiplicationStrategy::Heap;
+
+    const double heapCost = computedPairs * std::log2(std::min(n, m) + 1.0);
+    const double insertCost = distinct <= HashCacheEntries ? HashInsertCost : HashMissInsertCost;
+    const double hashCost = insertCost * computedPairs + HashSortCost * distinct * std::log2(distinct + 1.0);
+
+    return hashCost < heapCost ? MultiplicationStrategy::Hash : MultiplicationStrategy::Heap;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyDense(const BasicPolynomial& a, const DegreeBounds& ba, const BasicPolynomial& b, const DegreeBounds& bb)
+    requires IsFloatingPoint
+{
+    // Подстановка Кронекера: степень (w, x, y, z) за вычетом минимальных степеней отображается в индекс
+    // ((w * Dx + x) * Dy + y) * Dz + z, где Dv - число возможных степеней переменной v в произведении
+    // (для другого числа переменных - аналогично). Переносов между разрядами не возникает, поэтому
+    // произведение многочленов от нескольких переменных становится сверткой одномерных последовательностей
+    uint64_t dims[NVars];
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        dims[var] = static_cast<uint64_t>(ba.max[var] - ba.min[var]) + (bb.max[var] - bb.min[var]) + 1;
+    }
+
+    auto toIndex = [&dims](uint64_t degree, const DegreeBounds& bounds)
+    {
+        uint64_t index = 0;
+        for (unsigned var = 0; var < NVars; ++var)
+        {
+            index = index * dims[var] + (variableDegree(degree, var) - bounds.min[var]);
+        }
+        return index;
+    };
+
+    auto toDense = [&toIndex](const BasicPolynomial& p, const DegreeBounds& bounds)
+    {
+        // Первый моном имеет наибольшую степень и, следовательно, наибольший индекс
+        std::vector<int64_t> dense(toIndex(p.mDegrees.front(), bounds) + 1, 0);
+        for (size_t i = 0; i < p.size(); ++i)
+        {
+            dense[toIndex(p.mDegrees[i], bounds)] = static_cast<int64_t>(p.mCoefficients[i]);
+        }
+        return dense;
+    };
+
+    std::vector<int64_t> product;
+    if (&a == &b)
+    {
+        const std::vector<int64_t> dense = toDense(a, ba);
+        product = Ntt::convolve(dense, dense);
+    } else
+    {
+        product = Ntt::convolve(toDense(a, ba), toDense(b, bb));
+    }
+
+    uint32_t offset[NVars];
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        offset[var] = ba.min[var] + bb.min[var];
+    }
+
+    BasicPolynomial res;
+    // Индекс монотонен по упакованной степени, поэтому проход от конца дает мономы по убыванию степени
+    for (size_t index = product.size(); index-- > 0;)
+    {
+        if (product[index] == 0) continue;
+
+        Exponents degrees;
+        uint64_t rest = index;
+        for (unsigned var = NVars; var-- > 0;)
+        {
+            degrees[var] = static_cast<uint32_t>(rest % dims[var]) + offset[var];
+            rest /= dims[var];
+        }
+
+        res.pushBack(packDegree(degrees), static_cast<double>(product[index]));
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyHeapRange(const BasicPolynomial& a, const BasicPolynomial& b, uint64_t lowDegree, uint64_t highDegree)
+{
+    // То же слияние кучей, но только для произведений со степенью из [lowDegree, highDegree].
+    // Начало каждой строки ищется бинарным поиском, поэтому все строки сразу помещаются в кучу
+    struct HeapEntry
+    {
+        uint64_t degree;
+        uint32_t i;
+        uint32_t j;
+
+        bool operator<(const HeapEntry& other) const noexcept { return degree < other.degree; }
+    };
+
+    BasicPolynomial res;
+    const size_t m = b.size();
+
+    std::vector<HeapEntry> heap;
+    heap.reserve(a.size());
+
+    for (size_t i = 0; i < a.size(); ++i)
+    {
+        const uint64_t rowDegree = a.mDegrees[i];
+        if (rowDegree > highDegree) continue;
+
+        // b отсортирован по убыванию: первый j, для которого a[i] + b[j] <= highDegree
+        const uint64_t limit = highDegree - rowDegree;
+        size_t j = std::lower_bound(b.mDegrees.begin(), b.mDegrees.end(), limit, std::greater<uint64_t>()) - b.mDegrees.begin();
+
+        if (j < m && rowDegree + b.mDegrees[j] >= lowDegree)
+        {
+            heap.push_back({ rowDegree + b.mDegrees[j], static_cast<uint32_t>(i), static_cast<uint32_t>(j) });
+        }
+    }
+
+    std::make_heap(heap.begin(), heap.end());
+
+    while (!heap.empty())
+    {
+        const uint64_t degree = heap.front().degree;
+        Coefficient coefficient = Coefficient();
+
+        while (!heap.empty() && heap.front().degree == degree)
+        {
+            std::pop_heap(heap.begin(), heap.end());
+            HeapEntry& top = heap.back();
+            coefficient += a.mCoefficients[top.i] * b.mCoefficients[top.j];
+
+            if (top.j + 1 < m && a.mDegrees[top.i] + b.mDegrees[top.j + 1] >= lowDegree)
+            {
+                ++top.j;
+                top.degree = a.mDegrees[top.i] + b.mDegrees[top.j];
+                std::push_heap(heap.begin(), heap.end());
+            } else
+            {
+                heap.pop_back();
+            }
+        }
+
+        if (coefficient != Coefficient())
+        {
+            res.pushBack(degree, coefficient);
+        }
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyParallel(const BasicPolynomial& a, const BasicPolynomial& b, unsigned threadCount)
+{
+    // Пространство степеней произведения делится на threadCount непересекающихся отрезков, каждый поток
+    // вычисляет мономы своего отрезка. Границы отрезков - квантили степеней случайной выборки пар мономов,
+    // так что на каждый поток приходится примерно одинаковое число пар. Результаты потоков уже упорядочены
+    // между собой и просто склеиваются
+    const size_t sampleCount = 64 * static_cast<size_t>(threadCount);
+    std::vector<uint64_t> samples(sampleCount);
+
+    uint64_t state = 0x9E3779B97F4A7C15ull;
+    for (auto& sample : samples)
+    {
+        // линейный конгруэнтный генератор: выборка должна быть воспроизводимой
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        size_t i = static_cast<size_t>((state >> 33) % a.size());
+        state = state * 6364136223846793005ull + 1442695040888963407ull;
+        size_t j = static_cast<size_t>((state >> 33) % b.size());
+        sample = a.mDegrees[i] + b.mDegrees[j];
+    }
+    std::sort(samples.begin(), samples.end(), std::greater<uint64_t>());
+
+    struct DegreeRange
+    {
+        uint64_t low;
+        uint64_t high;
+    };
+
+    std::vector<DegreeRange> ranges;
+    uint64_t high = UINT64_MAX;
+    for (unsigned t = 1; t < threadCount && high > 0; ++t)
+    {
+        uint64_t low = std::min(samples[t * sampleCount / threadCount], high);
+        if (low == 0) break;
+
+        ranges.push_back({ low, high });
+        high = low - 1;
+    }
+    ranges.push_back({ 0, high });
+
+    ThreadPool& pool = multiplicationPool();
+    std::vector<std::future<BasicPolynomial>> parts;
+    parts.reserve(ranges.size());
+    for (const auto& range : ranges)
+    {
+        parts.push_back(pool.submit([&a, &b, range] { return multiplyHeapRange(a, b, range.low, range.high); }));
+    }
+
+    std::vector<BasicPolynomial> results;
+    results.reserve(parts.size());
+    size_t total = 0;
+    for (auto& part : parts)
+    {
+        results.push_back(part.get());
+        total += results.back().size();
+    }
+
+    BasicPolynomial res;
+    res.reserve(total);
+    for (const auto& part : results)
+    {
+        res.mDegrees.insert(res.mDegrees.end(), part.mDegrees.begin(), part.mDegrees.end());
+        res.mCoefficients.insert(res.mCoefficients.end(), part.mCoefficients.begin(), part.mCoefficients.end());
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::setMultiplicationThreads(unsigned threadCount)
+{
+    sMultiplicationThreads = threadCount;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+unsigned BasicPolynomial<NVars, Bits, Coefficient>::multiplicationThreads() noexcept
+{
+    unsigned threadCount = sMultiplicationThreads;
+    return threadCount != 0 ? threadCount : std::max(1u, std::thread::hardware_concurrency());
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplySparse(const BasicPolynomial& a, const BasicPolynomial& b)
+{
+    if (a.size() == 0 || b.size() == 0) return BasicPolynomial();
+
+    const DegreeBounds boundsA = a.degreeBounds();
+    const DegreeBounds boundsB = b.degreeBounds();
+    checkMultiplicationOverflow(boundsA, boundsB);
+
+    // Куча строится по строкам меньшего сомножителя
+    const BasicPolynomial& shorter = a.size() <= b.size() ? a : b;
+    const BasicPolynomial& longer = a.size() <= b.size() ? b : a;
+
+    switch (chooseMultiplication(a, boundsA, b, boundsB))
+    {
+    case MultiplicationStrategy::Monomial:
+        // умножение на одночлен (в частности, на число) сдвигает все степени на одну и ту же величину
+        return multiplyByMonomial(longer, shorter.mDegrees[0], shorter.mCoefficients[0]);
+    case MultiplicationStrategy::Dense:
+        if constexpr (IsFloatingPoint)
+        {
+            return multiplyDense(a, boundsA, b, boundsB);
+        }
+        break;
+    case MultiplicationStrategy::Parallel:
+        return multiplyParallel(shorter, longer, multiplicationThreads());
+    case MultiplicationStrategy::Hash:
+        return multiplyHash(shorter, longer, static_cast<size_t>(std::min(static_cast<double>(a.size()) * static_cast<double>(b.size()), productLength(boundsA, boundsB))));
+    case MultiplicationStrategy::Heap:
+        break;
+    }
+
+    return multiplyHeap(shorter, longer);
+}
+
+// Произведение почти заполняет свою область степеней чаще сомножителей, поэтому форма результата
+// выбирается заново
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator*(const BasicPolynomial& other) const
+{
+    BasicPolynomial sparseThis, sparseOther;
+    BasicPolynomial res = multiplySparse(sparseForm(*this, sparseThis), sparseForm(other, sparseOther));
+    res.chooseRepresentation();
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+MultiplicationStrategy BasicPolynomial<NVars, Bits, Coefficient>::multiplicationStrategy(const BasicPolynomial& other) const
+{
+    if (size() == 0 || other.size() == 0) return MultiplicationStrategy::Monomial;
+
+    BasicPolynomial sparseThis, sparseOther;
+    const BasicPolynomial& a = sparseForm(*this, sparseThis);
+    const BasicPolynomial& b = this == &other ? a : sparseForm(other, sparseOther);
+    return chooseMultiplication(a, a.degreeBounds(), b, b.degreeBounds());
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyByMonomial(const BasicPolynomial& p, uint64_t degree, Coefficient coefficient)
+{
+    BasicPolynomial res;
+    res.reserve(p.size());
+
+    for (size_t i = 0; i < p.size(); ++i)
+    {
+        const Coefficient product = p.mCoefficients[i] * coefficient;
+        if (product != Coefficient())
+        {
+            res.pushBack(p.mDegrees[i] + degree, product);
+        }
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::squareSparse(const BasicPolynomial& a)
+{
+    if (a.size() == 0) return BasicPolynomial();
+    if (a.size() == 1) return a.pow(2);
+
+    const DegreeBounds bounds = a.degreeBounds();
+    checkMultiplicationOverflow(bounds, bounds);
+
+    switch (chooseMultiplication(a, bounds, a, bounds))
+    {
+    case MultiplicationStrategy::Dense:
+        if constexpr (IsFloatingPoint)
+        {
+            return multiplyDense(a, bounds, a, bounds);
+        }
+        break;
+    case MultiplicationStrategy::Parallel:
+        return multiplyParallel(a, a, multiplicationThreads());
+    case MultiplicationStrategy::Hash:
+    {
+        const double pairs = 0.5 * static_cast<double>(a.size()) * static_cast<double>(a.size() + 1);
+        return multiplyHash(a, a, static_cast<size_t>(std::min(pairs, productLength(bounds, bounds))));
+    }
+    default:
+        break;
+    }
+
+    return squareHeap(a);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::square() const
+{
+    BasicPolynomial sparseThis;
+    BasicPolynomial res = squareSparse(sparseForm(*this, sparseThis));
+    res.chooseRepresentation();
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::pow(unsigned long exponent) const
+{
+    if (exponent == 0) return BasicPolynomial(Coefficient(1));
+    if (size() == 0) return BasicPolynomial();
+    if (isDense()) return sparseCopy().pow(exponent);
+
+    const DegreeBounds bounds = degreeBounds();
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        if (bounds.max[var] != 0 && exponent > MaxDegree / bounds.max[var])
+        {
+            throw "Overflow in exponentiation occurred";
+        }
+    }
+
+    if (size() == 1)
+    {
+        // у одночлена показатель применяется напрямую: ни одно поле не переполняется (проверено выше),
+        // поэтому упакованную степень можно умножить на показатель целиком
+        const uint64_t degree = mDegrees[0] * exponent;
+        BasicPolynomial res;
+        if constexpr (IsFloatingPoint)
+        {
+            res.pushBack(degree, std::pow(mCoefficients[0], exponent));
+        } else
+        {
+            res.pushBack(degree, mCoefficients[0].pow(exponent));
+        }
+        return res;
+    }
+
+    // Возведение в квадрат слева направо: на каждом шаге p^m -> p^(2m), затем, если бит показателя
+    // равен 1, умножение на исходный (короткий) полином. Если растущая степень почти плотная и большая,
+    // квадрат (|p^m|^2 / 2 пар мономов) может оказаться дороже m умножений на исходный полином
+    // (не меньше m * n * |p^m| пар), тогда шаг удвоения выполняется этими умножениями
+    unsigned long bit = 1;
+    while (bit <= exponent / 2) bit <<= 1;
+
+    BasicPolynomial res = *this;
+    unsigned long power = 1;
+    for (bit >>= 1; bit != 0; bit >>= 1)
+    {
+        const DegreeBounds resBounds = res.degreeBounds();
+        double squareCost = 0.5 * static_cast<double>(res.size()) * static_cast<double>(res.size());
+        if (isDenseProductProfitable(res, resBounds, res, resBounds))
+        {
+            squareCost = denseProductCost(resBounds, resBounds);
+        }
+        const double multiplicationCost = static_cast<double>(power) * static_cast<double>(size()) * static_cast<double>(res.size());
+
+        if (squareCost <= multiplicationCost)
+        {
+            res = squareSparse(res);
+        } else
+        {
+            for (unsigned long i = 0; i < power; ++i)
+            {
+                res = multiplySparse(res, *this);
+            }
+        }
+        power *= 2;
+
+        if (exponent & bit)
+        {
+            res = multiplySparse(res, *this);
+            ++power;
+        }
+    }
+
+    res.chooseRepresentation();
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::multiplyTruncated(const BasicPolynomial& a, const BasicPolynomial& b, uint64_t maxTotalDegree)
+{
+    // Мономы b переставляются по возрастанию полной степени. Тогда для монома a[i] полной степени t
+    // допустимые пары (полная степень b[j] не больше maxTotalDegree - t) образуют префикс этого порядка:
+    // пары выше границы не перебираются вовсе, а моном a[i], который выше границы даже с младшим
+    // мономом b, пропускается целиком. Произведения накапливаются в ProductAccumulator.
+    // Для квадрата (a и b - один объект) в том же порядке перебираются пары p <= q
+    struct Row
+    {
+        uint32_t i;     // номер монома a
+        uint32_t first; // допустимые мономы b - [first, last) в порядке полных степеней
+        uint32_t last;
+    };
+
+    const bool isSquare = &a == &b;
+    const size_t n = a.size();
+    const size_t m = b.size();
+    if (n == 0 || m == 0) return BasicPolynomial();
+
+    std::vector<std::pair<uint64_t, uint32_t>> order(m); // (полная степень, номер монома b)
+    for (size_t j = 0; j < m; ++j)
+    {
+        order[j] = { totalDegree(b.mDegrees[j]), static_cast<uint32_t>(j) };
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<uint64_t> degreesB(m);
+    std::vector<Coefficient> coefficientsB(m);
+    for (size_t q = 0; q < m; ++q)
+    {
+        degreesB[q] = b.mDegrees[order[q].second];
+        coefficientsB[q] = b.mCoefficients[order[q].second];
+    }
+
+    // число мономов b полной степени не больше limit
+    auto admissibleCount = [&order](uint64_t limit)
+    {
+        return static_cast<uint32_t>(std::upper_bound(order.begin(), order.end(), std::make_pair(limit, UINT32_MAX)) - order.begin());
+    };
+
+    std::vector<Row> rows;
+    double pairs = 0.0;
+    if (isSquare)
+    {
+        for (uint32_t p = 0; p < m && 2 * order[p].first <= maxTotalDegree; ++p)
+        {
+            const uint32_t last = admissibleCount(maxTotalDegree - order[p].first);
+            rows.push_back({ order[p].second, p, last });
+            pairs += last - p;
+        }
+    } else
+    {
+        const uint64_t minTotalB = order[0].first;
+        for (uint32_t i = 0; i < n; ++i)
+        {
+            const uint64_t total = totalDegree(a.mDegrees[i]);
+            if (total > maxTotalDegree || maxTotalDegree - total < minTotalB) continue;
+
+            const uint32_t last = admissibleCount(maxTotalDegree - total);
+            rows.push_back({ i, 0, last });
+            pairs += last;
+        }
+    }
+    if (rows.empty()) return BasicPolynomial();
+
+    // Различных степеней не больше числа пар, длины плотного представления произведения и числа
+    // мономов от NVars переменных полной степени не выше границы: C(maxTotalDegree + NVars, NVars)
+    double monomials = 1.0;
+    for (unsigned k = 1; k <= NVars; ++k)
+    {
+        monomials = monomials * (static_cast<double>(maxTotalDegree) + k) / k;
+    }
+    const double expectedSize = std::min({ pairs, productLength(a.degreeBounds(), b.degreeBounds()), monomials });
+
+    // У допустимой пары каждый показатель не больше полной степени, поэтому при границе не выше
+    // MaxDegree переполнение невозможно; иначе оно проверяется для каждой пары
+    const bool checkOverflow = maxTotalDegree > MaxDegree;
+
+    ProductAccumulator<Coefficient> accumulator(static_cast<size_t>(expectedSize));
+    for (const Row& row : rows)
+    {
+        const uint64_t degreeA = a.mDegrees[row.i];
+        const Coefficient coefficientA = a.mCoefficients[row.i];
+        for (uint32_t q = row.first; q < row.last; ++q)
+        {
+            if (checkOverflow && degreeSumOverflows(degreeA, degreesB[q]))
+            {
+                throw "Overflow in multiplication occurred";
+            }
+
+            Coefficient product = coefficientA * coefficientsB[q];
+            if (isSquare && q != row.first) product += product;
+            accumulator.add(degreeA + degreesB[q], product);
+        }
+    }
+
+    const auto& terms = accumulator.sortedTerms();
+    BasicPolynomial res;
+    res.reserve(terms.size());
+    for (const auto& [degree, coefficient] : terms)
+    {
+        if (coefficient != Coefficient())
+        {
+            res.pushBack(degree, coefficient);
+        }
+    }
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::truncated(uint64_t maxTotalDegree) const
+{
+    BasicPolynomial res;
+    forEachTerm([&res, maxTotalDegree](uint64_t degree, Coefficient coefficient)
+    {
+        if (totalDegree(degree) <= maxTotalDegree)
+        {
+            res.pushBack(degree, coefficient);
+        }
+        return true;
+    });
+
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::mulTruncatedSparse(const BasicPolynomial& a, const BasicPolynomial& b, uint64_t maxTotalDegree)
+{
+    if (a.size() == 0 || b.size() == 0) return BasicPolynomial();
+
+    const auto [minTotalA, maxTotalA] = a.totalDegreeRange();
+    const auto [minTotalB, maxTotalB] = b.totalDegreeRange();
+    if (minTotalA + minTotalB > maxTotalDegree) return BasicPolynomial();
+
+    // граница не ниже старшей полной степени произведения: усекать нечего, и способ умножения
+    // выбирается моделью стоимости
+    if (maxTotalA + maxTotalB <= maxTotalDegree)
+    {
+        return &a == &b ? squareSparse(a) : multiplySparse(a, b);
+    }
+
+    return multiplyTruncated(a, b, maxTotalDegree);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::mulTruncated(const BasicPolynomial& other, uint64_t maxTotalDegree) const
+{
+    BasicPolynomial sparseThis, sparseOther;
+    const BasicPolynomial& a = sparseForm(*this, sparseThis);
+    const BasicPolynomial& b = this == &other ? a : sparseForm(other, sparseOther);
+
+    BasicPolynomial res = mulTruncatedSparse(a, b, maxTotalDegree);
+    res.chooseRepresentation();
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::powTruncated(unsigned long exponent, uint64_t maxTotalDegree) const
+{
+    if (exponent == 0) return BasicPolynomial(Coefficient(1));
+    if (size() == 0) return BasicPolynomial();
+
+    // полные степени мономов p^exponent - от minTotal * exponent до maxTotal * exponent
+    BasicPolynomial sparseThis;
+    const BasicPolynomial& sparse = sparseForm(*this, sparseThis);
+    const auto [minTotal, maxTotal] = sparse.totalDegreeRange();
+    if (minTotal != 0 && exponent > maxTotalDegree / minTotal) return BasicPolynomial();
+    if (maxTotal == 0 || exponent <= maxTotalDegree / maxTotal) return pow(exponent);
+
+    // Возведение в квадрат слева направо, как в pow, но каждое произведение усекается, поэтому
+    // промежуточные степени не растут выше границы. Шаг удвоения p^m -> p^2m выполняется m умножениями
+    // на короткое основание, если это дешевле квадрата по числу пар мономов
+    const BasicPolynomial base = sparse.truncated(maxTotalDegree);
+
+    unsigned long bit = 1;
+    while (bit <= exponent / 2) bit <<= 1;
+
+    BasicPolynomial res = base;
+    unsigned long power = 1;
+    for (bit >>= 1; bit != 0 && res.size() != 0; bit >>= 1)
+    {
+        const double squareCost = 0.5 * static_cast<double>(res.size()) * static_cast<double>(res.size());
+        const double multiplicationCost = static_cast<double>(power) * static_cast<double>(base.size()) * static_cast<double>(res.size());
+        if (squareCost <= multiplicationCost)
+        {
+            res = mulTruncatedSparse(res, res, maxTotalDegree);
+        } else
+        {
+            for (unsigned long i = 0; i < power; ++i)
+            {
+                res = mulTruncatedSparse(res, base, maxTotalDegree);
+            }
+        }
+        power *= 2;
+
+        if (exponent & bit)
+        {
+            res = mulTruncatedSparse(res, base, maxTotalDegree);
+            ++power;
+        }
+    }
+
+    res.chooseRepresentation();
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator*(Coefficient coefficient) const&
+{
+    BasicPolynomial result;
+
+    if (coefficient == Coefficient()) return result;
+
+    result.mDegrees = mDegrees;
+    result.mBox = mBox;
+    result.mCoefficients.resize(mCoefficients.size());
+    for (size_t i = 0; i < mCoefficients.size(); ++i)
+    {
+        result.mCoefficients[i] = coefficient * mCoefficients[i];
+    }
+    if (result.isDense())
+    {
+        result.countTerms();
+    }
+
+    return result;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator*(Coefficient coefficient) &&
+{
+    *this *= coefficient;
+    return std::move(*this);
+}
+
+namespace
+{
+    const char sDigitPairs[] =
+        "00010203040506070809"
+        "10111213141516171819"
+        "20212223242526272829"
+        "30313233343536373839"
+        "40414243444546474849"
+        "50515253545556575859"
+        "60616263646566676869"
+        "70717273747576777879"
+        "80818283848586878889"
+        "90919293949596979899";
+
+    size_t exponentLength(uint32_t value) noexcept
+    {
+        size_t length = 1;
+        for (; value >= 100; value /= 100) length += 2;
+        return value >= 10 ? length + 1 : length;
+    }
+
+    // Записать показатель степени по две цифры за шаг
+    char* writeExponent(char* out, uint32_t value) noexcept
+    {
+        const size_t length = exponentLength(value);
+        char* p = out + length;
+        while (value >= 100)
+        {
+            const uint32_t pair = value % 100;
+            value /= 100;
+            p -= 2;
+            p[0] = sDigitPairs[2 * pair];
+            p[1] = sDigitPairs[2 * pair + 1];
+        }
+        if (value >= 10)
+        {
+            p -= 2;
+            p[0] = sDigitPairs[2 * value];
+            p[1] = sDigitPairs[2 * value + 1];
+        } else
+        {
+            *--p = static_cast<char>('0' + value);
+        }
+
+        return out + length;
+    }
+}
+
+// Коэффициент double записывается как в std::ostream по умолчанию: 6 значащих цифр (%g),
+// вычет по модулю - своим представителем из симметричного диапазона
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+size_t BasicPolynomial<NVars, Bits, Coefficient>::formatMonomial(char* out, uint64_t degree, Coefficient coefficient, bool leading) noexcept
+{
+    char* p = out;
+    if constexpr (IsFloatingPoint)
+    {
+        if (!leading && coefficient > 0.0)
+        {
+            *p++ = '+';
+        }
+        // Целые коэффициенты, меньшие 10^6 по модулю, %g записывает без точки и экспоненты
+        if (coefficient != 0.0 && std::abs(coefficient) < 1e6 && coefficient == std::trunc(coefficient))
+        {
+            p = std::to_chars(p, out + MaxMonomialChars, static_cast<int32_t>(coefficient)).ptr;
+        } else
+        {
+            p = std::to_chars(p, out + MaxMonomialChars, coefficient, std::chars_format::general, 6).ptr;
+        }
+    } else
+    {
+        const int64_t value = coefficient.signedValue();
+        if (!leading && value > 0)
+        {
+            *p++ = '+';
+        }
+        p = std::to_chars(p, out + MaxMonomialChars, value).ptr;
+    }
+
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        const uint32_t power = variableDegree(degree, var);
+        if (power == 0)
+        {
+            continue;
+        }
+
+        *p++ = '*';
+        *p++ = variableName(var);
+        if (power > 1)
+        {
+            *p++ = '^';
+            p = writeExponent(p, power);
+        }
+    }
+
+    return static_cast<size_t>(p - out);
+}
+
+// Оценка сверху длины записи: длину коэффициента считаем наибольшей, а множители - точно.
+// Подсчет прекращается, как только оценка превысила limit
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+size_t BasicPolynomial<NVars, Bits, Coefficient>::estimateTextLength(size_t limit) const noexcept
+{
+    if (size() == 0)
+    {
+        return 1;
+    }
+
+    size_t length = size() * (MaxCoefficientChars + 1);
+    forEachTerm([&length, limit](uint64_t degree, Coefficient)
+    {
+        for (unsigned var = 0; var < NVars; ++var)
+        {
+            const uint32_t power = variableDegree(degree, var);
+            if (power != 0)
+            {
+                length += power > 1 ? 3 + exponentLength(power) : 2;
+            }
+        }
+        return length <= limit;
+    });
+
+    return length;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::appendTo(std::string& out, size_t maxLength) const
 {
-    Polynomial result;
+    if (size() == 0)
+    {
+        if (maxLength != 0)
+        {
+            out.push_back('0');
+        }
+        return;
+    }
+
+    out.reserve(out.size() + std::min(estimateTextLength(maxLength), maxLength));
 
-    auto it1 = mMonomials.begin();
-    auto it2 = other.mMonomials.begin();
+    const char* ellipsis = "...";
+    const size_t ellipsisLength = 3;
 
-    while (it1 != mMonomials.end() && it2 != other.mMonomials.end())
+    char buffer[MaxMonomialChars];
+    size_t written = 0;
+    size_t i = 0;
+    forEachTerm([&](uint64_t degree, Coefficient coefficient)
     {
-        uint64_t deg1 = (*it1).degree();
-        uint64_t deg2 = (*it2).degree();
+        const size_t length = formatMonomial(buffer, degree, coefficient, i == 0);
 
-        if (deg1 > deg2)
-        {
-            result.mMonomials.pushBack(*it1);
-            ++it1;
-        } else if (deg2 > deg1)
+        // за непоследним мономом должно остаться место для многоточия
+        const size_t reserved = ++i < size() ? ellipsisLength : 0;
+        if (maxLength < reserved || written + length > maxLength - reserved)
         {
-            result.mMonomials.pushBack(*it2);
-            ++it2;
-        } else
+            out.append(ellipsis, std::min(ellipsisLength, maxLength - written));
+            return false;
+        }
+
+        out.append(buffer, length);
+        written += length;
+        return true;
+    });
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+std::to_chars_result BasicPolynomial<NVars, Bits, Coefficient>::toChars(char* first, char* last) const noexcept
+{
+    const size_t capacity = static_cast<size_t>(last - first);
+    if (size() == 0)
+    {
+        if (capacity == 0)
         {
-            double coefficient = (*it1).coefficient() + (*it2).coefficient();
-            if (coefficient != 0.0)
-            {
-                result.mMonomials.pushBack(Monomial(coefficient, (*it1).w(), (*it1).x(), (*it1).y(), (*it1).z()));
-            }
-            ++it1;
-            ++it2;
+            return { last, std::errc::value_too_large };
         }
+        *first = '0';
+        return { first + 1, std::errc() };
     }
 
-    while (it1 != mMonomials.end())
+    char buffer[MaxMonomialChars];
+    char* p = first;
+    const bool fits = forEachTerm([&](uint64_t degree, Coefficient coefficient)
     {
-        result.mMonomials.pushBack(*it1);
-        ++it1;
-    }
+        const size_t length = formatMonomial(buffer, degree, coefficient, p == first);
+        if (length > static_cast<size_t>(last - p))
+        {
+            return false;
+        }
+
+        std::memcpy(p, buffer, length);
+        p += length;
+        return true;
+    });
 
-    while (it2 != other.mMonomials.end())
+    if (!fits)
     {
-        result.mMonomials.pushBack(*it2);
-        ++it2;
+        return { last, std::errc::value_too_large };
     }
+    return { p, std::errc() };
+}
 
-    return result;
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator-() const&
+{
+    return (*this) * Coefficient(-1);
 }
 
-Polynomial Polynomial::operator*(const Polynomial& other) const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::operator-() &&
 {
-    Polynomial res{};
+    negate();
+    return std::move(*this);
+}
 
-    for (const auto& ms : mMonomials)
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::negate() noexcept
+{
+    invalidateEvaluationPlan();
+    for (Coefficient& coefficient : mCoefficients)
     {
-        Polynomial tmp{};
+        coefficient = -coefficient;
+    }
+}
 
-        for (const auto& mo : other.mMonomials)
-        {
-            double coef = ms.coefficient() * mo.coefficient();
-            uint32_t xDeg = ms.x() + mo.x();
-            uint32_t yDeg = ms.y() + mo.y();
-            uint32_t zDeg = ms.z() + mo.z();
-            uint32_t wDeg = ms.w() + mo.w();
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>& BasicPolynomial<NVars, Bits, Coefficient>::operator+=(const BasicPolynomial& other)
+{
+    mergeScaledInPlace(other, Coefficient(1));
+    return *this;
+}
 
-            if (xDeg > UINT16_MAX || yDeg > UINT16_MAX || zDeg > UINT16_MAX || wDeg > UINT16_MAX)
-            {
-                throw "Overflow in multiplication occurred";
-            }
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>& BasicPolynomial<NVars, Bits, Coefficient>::operator-=(const BasicPolynomial& other)
+{
+    mergeScaledInPlace(other, Coefficient(-1));
+    return *this;
+}
 
-            tmp.mMonomials.pushBack(Monomial(coef, wDeg, xDeg, yDeg, zDeg));
-        }
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>& BasicPolynomial<NVars, Bits, Coefficient>::operator*=(Coefficient coefficient)
+{
+    invalidateEvaluationPlan();
 
-        res += tmp;
+    if (coefficient == Coefficient())
+    {
+        mDegrees.clear();
+        mCoefficients.clear();
+        mBox = DenseBox();
+        return *this;
     }
 
-    return res;
+    for (Coefficient& c : mCoefficients)
+    {
+        c *= coefficient;
+    }
+    if (isDense())
+    {
+        countTerms();
+    }
+
+    return *this;
 }
 
-Polynomial Polynomial::operator*(double coefficient) const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+bool BasicPolynomial<NVars, Bits, Coefficient>::operator==(const BasicPolynomial& other) const
 {
-    Polynomial result;
-
-    if (coefficient == 0.0) return result;
-
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    if (isDense() || other.isDense())
     {
-        result.mMonomials.pushBack(Monomial(coefficient * (*it).coefficient(), (*it).w(), (*it).x(), (*it).y(), (*it).z()));
+        // формы с одной и той же областью сравниваются по ячейкам, остальные - по разреженным копиям
+        if (isDense() && other.isDense() && mBox.top == other.mBox.top
+            && std::equal(mBox.extent, mBox.extent + NVars, other.mBox.extent))
+        {
+            return mCoefficients == other.mCoefficients;
+        }
+
+        BasicPolynomial sparseThis, sparseOther;
+        return sparseForm(*this, sparseThis) == sparseForm(other, sparseOther);
     }
 
-    return result;
+    return mDegrees == other.mDegrees && mCoefficients == other.mCoefficients;
 }
 
-Polynomial operator*(double coefficient, const Polynomial& p)
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+bool BasicPolynomial<NVars, Bits, Coefficient>::operator!=(const BasicPolynomial& other) const
 {
-    return p * coefficient;
+    return !operator==(other);
 }
 
-std::ostream& operator<<(std::ostream& ostr, const Polynomial& p)
+// Схема вычисления - вложенная схема Горнера по переменным в порядке упаковки (w, x, y, z). Мономы отсортированы по
+// упакованной степени, поэтому мономы с одинаковой степенью w идут подряд, внутри них - с одинаковой
+// степенью x и т.д. Для группы мономов с показателями e1 > e2 > ... > ek переменной v:
+// P = (((P1 * v^(e1 - e2) + P2) * v^(e2 - e3) + ...) + Pk) * v^ek,
+// где Pi - значение вложенной схемы по следующим переменным. Схема записывается в виде программы
+// для стековой машины, а нужные степени v^g вычисляются один раз за вызов evaluate
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+struct BasicPolynomial<NVars, Bits, Coefficient>::EvaluationPlan
 {
-    if (p.mMonomials.size() == 0)
+    enum class StepKind : uint8_t
     {
-        ostr << 0;
-        return ostr;
-    }
+        PUSH,           // положить коэффициент на стек
+        MULT_POWER_ADD, // b = pop, a = pop, push(a * power + b)
+        MULT_POWER      // top *= power
+    };
+
+    struct Step
+    {
+        StepKind kind;
+        uint32_t power; // номер степени в powers
+        Coefficient coefficient;
+    };
 
-    bool first = true;
-    for (auto& v : p.mMonomials)
+    struct Power
     {
-        if (!first && v.coefficient() > 0.0) ostr << '+';
-        first = false;
+        uint8_t var;
+        uint32_t exponent;
+    };
+
+    static const size_t MaxStackDepth = NVars + 1; // по одному значению на каждый уровень вложенности и коэффициент
+    // Степеней большинства полиномов хватает на стеке; иначе буфер берется из currentMemoryResource()
+    static const size_t InlinePowerValues = 64;
 
-        ostr << v.coefficient();
-        if (v.w())
+    std::once_flag compiled; // схема строится при первом вычислении любой из копий
+    std::vector<Step> steps;
+    std::vector<Power> powers;
+    std::map<std::pair<uint8_t, uint32_t>, uint32_t> powerIndices; // нужна только при построении
+
+    uint32_t powerIndex(uint8_t var, uint32_t exponent)
+    {
+        auto it = powerIndices.try_emplace({ var, exponent }, static_cast<uint32_t>(powers.size())).first;
+        if (it->second == powers.size())
         {
-            ostr << "*w";
-            if (v.w() > 1) ostr << '^' << static_cast<int32_t>(v.w());
+            powers.push_back({ var, exponent });
         }
-        if (v.x())
+        return it->second;
+    }
+
+    void compile(const BasicPolynomial& p, unsigned var, size_t begin, size_t end)
+    {
+        if (var == NVars)
         {
-            ostr << "*x";
-            if (v.x() > 1) ostr << '^' << static_cast<int32_t>(v.x());
+            steps.push_back({ StepKind::PUSH, 0, p.mCoefficients[begin] });
+            return;
         }
-        if (v.y())
+
+        uint32_t previousExponent = 0;
+        bool first = true;
+        size_t groupBegin = begin;
+        while (groupBegin < end)
         {
-            ostr << "*y";
-            if (v.y() > 1) ostr << '^' << static_cast<int32_t>(v.y());
+            const uint32_t exponent = variableDegree(p.mDegrees[groupBegin], var);
+            size_t groupEnd = groupBegin + 1;
+            while (groupEnd < end && variableDegree(p.mDegrees[groupEnd], var) == exponent)
+            {
+                ++groupEnd;
+            }
+
+            compile(p, var + 1, groupBegin, groupEnd);
+            if (!first)
+            {
+                steps.push_back({ StepKind::MULT_POWER_ADD, powerIndex(static_cast<uint8_t>(var), previousExponent - exponent), Coefficient() });
+            }
+
+            first = false;
+            previousExponent = exponent;
+            groupBegin = groupEnd;
         }
-        if (v.z())
+
+        if (previousExponent != 0)
         {
-            ostr << "*z";
-            if (v.z() > 1) ostr << '^' << static_cast<int32_t>(v.z());
+            steps.push_back({ StepKind::MULT_POWER, powerIndex(static_cast<uint8_t>(var), previousExponent), Coefficient() });
         }
     }
 
-    return ostr;
-}
+    Coefficient run(const std::array<Coefficient, NVars>& values) const
+    {
+        SmallVector<Coefficient, InlinePowerValues> powerValues;
+        powerValues.resize(powers.size());
+        for (size_t i = 0; i < powers.size(); ++i)
+        {
+            Coefficient base = values[powers[i].var];
+            Coefficient result = Coefficient(1);
+            for (uint32_t e = powers[i].exponent; e != 0; e >>= 1)
+            {
+                if (e & 1) result *= base;
+                base *= base;
+            }
+            powerValues[i] = result;
+        }
 
-Polynomial Polynomial::operator-() const
-{
-    return (*this) * -1.0;
-}
+        Coefficient stack[MaxStackDepth] = {};
+        size_t top = 0;
+        for (const Step& step : steps)
+        {
+            switch (step.kind)
+            {
+            case StepKind::PUSH:
+                stack[top++] = step.coefficient;
+                break;
+            case StepKind::MULT_POWER_ADD:
+                --top;
+                stack[top - 1] = stack[top - 1] * powerValues[step.power] + stack[top];
+                break;
+            case StepKind::MULT_POWER:
+                stack[top - 1] *= powerValues[step.power];
+                break;
+            }
+        }
 
-Polynomial Polynomial::operator-(const Polynomial& other) const
-{
-    return (*this) + (-other);
-}
+        return stack[0];
+    }
+};
 
-Polynomial& Polynomial::operator+=(const Polynomial& other)
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+std::shared_ptr<typename BasicPolynomial<NVars, Bits, Coefficient>::EvaluationPlan> BasicPolynomial<NVars, Bits, Coefficient>::sharedEvaluationPlan() const
 {
-    *this = *this + other;
-    return *this;
-}
+    std::shared_ptr<EvaluationPlan> plan = mEvaluationPlan.load();
+    if (plan || size() == 0 || isDense()) return plan;
 
-Polynomial& Polynomial::operator-=(const Polynomial& other)
-{
-    *this = *this - other;
-    return *this;
+    // если другой поток успел создать схему раньше, используется его схема
+    auto created = std::make_shared<EvaluationPlan>();
+    if (mEvaluationPlan.compare_exchange_strong(plan, created))
+    {
+        return created;
+    }
+    return plan;
 }
 
-Polynomial& Polynomial::operator*=(double coefficient)
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+Coefficient BasicPolynomial<NVars, Bits, Coefficient>::evaluate(const std::array<Coefficient, NVars>& point) const
 {
-    *this = *this * coefficient;
-    return *this;
+    if (size() == 0) return Coefficient();
+    if (isDense()) return evaluateDense(point);
+
+    std::shared_ptr<EvaluationPlan> plan = sharedEvaluationPlan();
+    std::call_once(plan->compiled, [&]()
+    {
+        plan->compile(*this, 0, 0, size());
+        plan->powerIndices.clear();
+    });
+
+    return plan->run(point);
 }
 
-bool Polynomial::operator==(const Polynomial& other) const
+// Плотная форма вычисляется вложенной схемой Горнера прямо по ячейкам области: для переменной v
+// значения вложенных схем по строкам с показателями top, top - 1, ..., low объединяются по Горнеру,
+// и результат умножается на v^low. Схема вычисления для этого не нужна
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+Coefficient BasicPolynomial<NVars, Bits, Coefficient>::evaluateDense(const std::array<Coefficient, NVars>& point) const
 {
-    if (mMonomials.size() != other.mMonomials.size())
+    size_t strides[NVars];
+    Coefficient lowPowers[NVars];
+    size_t stride = 1;
+    for (unsigned var = NVars; var-- > 0;)
     {
-        return false;
+        strides[var] = stride;
+        stride *= mBox.extent[var];
+
+        Coefficient base = point[var];
+        Coefficient power = Coefficient(1);
+        for (uint32_t e = variableDegree(mBox.top, var) - (mBox.extent[var] - 1); e != 0; e >>= 1)
+        {
+            if (e & 1) power *= base;
+            base *= base;
+        }
+        lowPowers[var] = power;
     }
 
-    for (auto it1 = mMonomials.begin(), it2 = other.mMonomials.begin(); it1 != mMonomials.end() && it2 != other.mMonomials.end(); ++it1, ++it2)
+    auto nested = [&](auto& self, unsigned var, size_t begin) -> Coefficient
     {
-        if (*it1 != *it2)
+        Coefficient value = Coefficient();
+        for (uint32_t k = 0; k < mBox.extent[var]; ++k)
         {
-            return false;
+            const size_t row = begin + k * strides[var];
+            value = value * point[var] + (var + 1 == NVars ? mCoefficients[row] : self(self, var + 1, row));
         }
-    }
+        return value * lowPowers[var];
+    };
 
-    return true;
+    return nested(nested, 0, 0);
 }
 
-bool Polynomial::operator!=(const Polynomial& other) const
+namespace
 {
-    return !operator==(other);
-}
+    // Число точек, обрабатываемых вместе: таблицы степеней хранятся по строкам из BatchBlock
+    // значений, поэтому для каждого монома значения во всех точках блока лежат подряд
+    const size_t BatchBlock = 16;
+
+    // acc[i] += c * p0[i] * p1[i] * ... для всех мономов, i < BatchBlock, где pv - строка таблицы
+    // степеней переменной v для монома
+    template <unsigned NVars>
+    void accumulateBlock(size_t termCount, const double* coefficients,
+        const uint32_t* const rows[NVars], const double* const powers[NVars], double* acc)
+    {
+#if defined(__AVX512F__)
+        __m512d acc0 = _mm512_setzero_pd();
+        __m512d acc1 = _mm512_setzero_pd();
+        for (size_t t = 0; t < termCount; ++t)
+        {
+            const double* p = powers[0] + rows[0][t] * BatchBlock;
+            __m512d m0 = _mm512_loadu_pd(p);
+            __m512d m1 = _mm512_loadu_pd(p + 8);
+            for (unsigned var = 1; var < NVars; ++var)
+            {
+                p = powers[var] + rows[var][t] * BatchBlock;
+                m0 = _mm512_mul_pd(m0, _mm512_loadu_pd(p));
+                m1 = _mm512_mul_pd(m1, _mm512_loadu_pd(p + 8));
+            }
 
-double Polynomial::evaluate(double w, double x, double y, double z) const
-{
-    double res = 0.0;
+            const __m512d c = _mm512_set1_pd(coefficients[t]);
+            acc0 = _mm512_add_pd(acc0, _mm512_mul_pd(c, m0));
+            acc1 = _mm512_add_pd(acc1, _mm512_mul_pd(c, m1));
+        }
+        _mm512_storeu_pd(acc, acc0);
+        _mm512_storeu_pd(acc + 8, acc1);
+#elif defined(__AVX2__)
+        __m256d accs[4] = { _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd(), _mm256_setzero_pd() };
+        for (size_t t = 0; t < termCount; ++t)
+        {
+            const double* p0 = powers[0] + rows[0][t] * BatchBlock;
+            __m256d m[4];
+            for (size_t k = 0; k < 4; ++k)
+            {
+                m[k] = _mm256_loadu_pd(p0 + 4 * k);
+            }
+            for (unsigned var = 1; var < NVars; ++var)
+            {
+                const double* p = powers[var] + rows[var][t] * BatchBlock;
+                for (size_t k = 0; k < 4; ++k)
+                {
+                    m[k] = _mm256_mul_pd(m[k], _mm256_loadu_pd(p + 4 * k));
+                }
+            }
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
-    {
-        res += (*it).coefficient() *
-            pow(w, static_cast<double>((*it).w())) *
-            pow(x, static_cast<double>((*it).x())) *
-            pow(y, static_cast<double>((*it).y())) *
-            pow(z, static_cast<double>((*it).z()));
+            const __m256d c = _mm256_set1_pd(coefficients[t]);
+            for (size_t k = 0; k < 4; ++k)
+            {
+                accs[k] = _mm256_add_pd(accs[k], _mm256_mul_pd(c, m[k]));
+            }
+        }
+        for (size_t k = 0; k < 4; ++k)
+        {
+            _mm256_storeu_pd(acc + 4 * k, accs[k]);
+        }
+#else
+        double sums[BatchBlock] = {};
+        for (size_t t = 0; t < termCount; ++t)
+        {
+            double m[BatchBlock];
+            const double* p0 = powers[0] + rows[0][t] * BatchBlock;
+            std::copy(p0, p0 + BatchBlock, m);
+            for (unsigned var = 1; var < NVars; ++var)
+            {
+                const double* p = powers[var] + rows[var][t] * BatchBlock;
+                for (size_t i = 0; i < BatchBlock; ++i)
+                {
+                    m[i] *= p[i];
+                }
+            }
+
+            const double c = coefficients[t];
+            for (size_t i = 0; i < BatchBlock; ++i)
+            {
+                sums[i] += c * m[i];
+            }
+        }
+        std::copy(sums, sums + BatchBlock, acc);
+#endif
     }
 
-    return res;
+    // Заполнить строки таблицы степеней для возрастающих показателей exponents:
+    // каждая следующая степень получается из предыдущей умножением на base^(разность показателей)
+    void fillPowers(const std::vector<uint32_t>& exponents, const double* base, double* table)
+    {
+        double previous[BatchBlock];
+        std::fill(previous, previous + BatchBlock, 1.0);
+        uint32_t previousExponent = 0;
+
+        for (size_t k = 0; k < exponents.size(); ++k)
+        {
+            uint32_t gap = exponents[k] - previousExponent;
+            double step[BatchBlock];
+            double square[BatchBlock];
+            std::fill(step, step + BatchBlock, 1.0);
+            std::copy(base, base + BatchBlock, square);
+
+            while (gap != 0)
+            {
+                if (gap & 1)
+                {
+                    for (size_t i = 0; i < BatchBlock; ++i) step[i] *= square[i];
+                }
+                gap >>= 1;
+                if (gap != 0)
+                {
+                    for (size_t i = 0; i < BatchBlock; ++i) square[i] *= square[i];
+                }
+            }
+
+            double* row = table + k * BatchBlock;
+            for (size_t i = 0; i < BatchBlock; ++i)
+            {
+                row[i] = previous[i] * step[i];
+                previous[i] = row[i];
+            }
+            previousExponent = exponents[k];
+        }
+    }
 }
 
-Polynomial Polynomial::derivativeW() const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::evaluateBatch(const std::array<const double*, NVars>& coordinates, double* result, size_t count) const
+    requires IsFloatingPoint
 {
-    Polynomial res;
+    if (count == 0) return;
+
+    if (size() == 0)
+    {
+        std::fill(result, result + count, 0.0);
+        return;
+    }
+    if (isDense())
+    {
+        sparseCopy().evaluateBatch(coordinates, result, count);
+        return;
+    }
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    // Для каждой переменной - возрастающий список различных показателей и номер строки
+    // таблицы степеней для каждого монома
+    std::vector<uint32_t> exponents[NVars];
+    std::vector<uint32_t> rows[NVars];
+    for (unsigned var = 0; var < NVars; ++var)
     {
-        uint16_t degree = (*it).w();
-        if (degree > 0)
+        std::vector<uint32_t>& e = exponents[var];
+        e.resize(size());
+        for (size_t t = 0; t < size(); ++t)
         {
-            res.mMonomials.pushBack(
-                Monomial(static_cast<double>(degree) * (*it).coefficient(), (*it).w() - 1, (*it).x(), (*it).y(), (*it).z())
-            );
+            e[t] = variableDegree(mDegrees[t], var);
         }
-    }
+        std::sort(e.begin(), e.end());
+        e.erase(std::unique(e.begin(), e.end()), e.end());
 
-    return res;
-}
+        rows[var].resize(size());
+        for (size_t t = 0; t < size(); ++t)
+        {
+            rows[var][t] = static_cast<uint32_t>(
+                std::lower_bound(e.begin(), e.end(), variableDegree(mDegrees[t], var)) - e.begin());
+        }
+    }
 
-Polynomial Polynomial::derivativeX() const
-{
-    Polynomial res;
+    std::vector<double> tables[NVars];
+    const uint32_t* rowPointers[NVars];
+    const double* powers[NVars];
+    for (unsigned var = 0; var < NVars; ++var)
+    {
+        tables[var].resize(exponents[var].size() * BatchBlock);
+        rowPointers[var] = rows[var].data();
+        powers[var] = tables[var].data();
+    }
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    for (size_t start = 0; start < count; start += BatchBlock)
     {
-        uint16_t degree = (*it).x();
-        if (degree > 0)
+        const size_t lanes = std::min(BatchBlock, count - start);
+
+        for (unsigned var = 0; var < NVars; ++var)
         {
-            res.mMonomials.pushBack(
-                Monomial(static_cast<double>(degree) * (*it).coefficient(), (*it).w(), (*it).x() - 1, (*it).y(), (*it).z())
-            );
+            // неполный последний блок дополняется нулями
+            double base[BatchBlock] = {};
+            std::copy(coordinates[var] + start, coordinates[var] + start + lanes, base);
+            fillPowers(exponents[var], base, tables[var].data());
         }
+
+        double acc[BatchBlock];
+        accumulateBlock<NVars>(size(), mCoefficients.data(), rowPointers, powers, acc);
+        std::copy(acc, acc + lanes, result + start);
+    }
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+uint64_t BasicPolynomial<NVars, Bits, Coefficient>::variableUnit(unsigned var)
+{
+    if (var >= NVars)
+    {
+        throw std::invalid_argument(__FUNCTION__ ": variable index must be less than the number of variables.");
     }
 
-    return res;
+    return uint64_t(1) << variableShift(var);
 }
 
-Polynomial Polynomial::derivativeY() const
+// Так как степени всех мономов изменяются на одну и ту же величину, мономы остаются отсортированными
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::derivative(unsigned var) const
 {
-    Polynomial res;
+    if (isDense()) return sparseCopy().derivative(var);
+
+    const uint64_t unit = variableUnit(var);
+    BasicPolynomial res;
+    res.reserve(size());
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    for (size_t i = 0; i < size(); ++i)
     {
-        uint16_t degree = (*it).y();
-        if (degree > 0)
+        if (!degreeDifferenceUnderflows(mDegrees[i], unit))
         {
-            res.mMonomials.pushBack(
-                Monomial(static_cast<double>(degree) * (*it).coefficient(), (*it).w(), (*it).x(), (*it).y() - 1, (*it).z())
-            );
+            res.pushBack(mDegrees[i] - unit, Coefficient(variableDegree(mDegrees[i], var)) * mCoefficients[i]);
         }
     }
 
     return res;
 }
 
-Polynomial Polynomial::derivativeZ() const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::integral(unsigned var) const
+{
+    BasicPolynomial res(*this);
+    res.integrate(var);
+    return res;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::differentiate(unsigned var)
 {
-    Polynomial res;
+    const uint64_t unit = variableUnit(var);
+    invalidateEvaluationPlan();
+    makeSparse();
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    // мономы без переменной var исчезают, остальные сдвигаются к началу массивов
+    size_t count = 0;
+    for (size_t i = 0; i < size(); ++i)
     {
-        uint16_t degree = (*it).z();
-        if (degree > 0)
+        if (!degreeDifferenceUnderflows(mDegrees[i], unit))
         {
-            res.mMonomials.pushBack(
-                Monomial(static_cast<double>(degree) * (*it).coefficient(), (*it).w(), (*it).x(), (*it).y(), (*it).z() - 1)
-            );
+            mCoefficients[count] = Coefficient(variableDegree(mDegrees[i], var)) * mCoefficients[i];
+            mDegrees[count] = mDegrees[i] - unit;
+            ++count;
         }
     }
 
-    return res;
+    mDegrees.resize(count);
+    mCoefficients.resize(count);
 }
 
-Polynomial Polynomial::integralX() const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+void BasicPolynomial<NVars, Bits, Coefficient>::integrate(unsigned var)
 {
-    Polynomial res;
+    const uint64_t unit = variableUnit(var);
+    makeSparse();
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    // проверка до изменений, чтобы при переполнении полином остался прежним
+    for (size_t i = 0; i < size(); ++i)
     {
-        uint16_t degree = (*it).x();
-        if (degree < UINT16_MAX)
-        {
-            res.mMonomials.pushBack(
-                Monomial((*it).coefficient() / static_cast<double>(degree + 1), (*it).w(), (*it).x() + 1, (*it).y(), (*it).z())
-            );
-        } else
+        if (degreeSumOverflows(mDegrees[i], unit))
         {
             throw "Overflow in integration occurred";
         }
     }
 
-    return res;
+    invalidateEvaluationPlan();
+    for (size_t i = 0; i < size(); ++i)
+    {
+        mCoefficients[i] /= Coefficient(variableDegree(mDegrees[i], var) + 1);
+        mDegrees[i] += unit;
+    }
 }
 
-Polynomial Polynomial::integralY() const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+std::array<BasicPolynomial<NVars, Bits, Coefficient>, NVars> BasicPolynomial<NVars, Bits, Coefficient>::gradient() const
 {
-    Polynomial res;
+    if (isDense()) return sparseCopy().gradient();
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    std::array<BasicPolynomial, NVars> res;
+    for (BasicPolynomial& partial : res)
     {
-        uint16_t degree = (*it).y();
-        if (degree < UINT16_MAX)
-        {
-            res.mMonomials.pushBack(
-                Monomial((*it).coefficient() / static_cast<double>(degree + 1), (*it).w(), (*it).x(), (*it).y() + 1, (*it).z())
-            );
-        } else
+        partial.reserve(size());
+    }
+
+    for (size_t i = 0; i < size(); ++i)
+    {
+        const uint64_t degree = mDegrees[i];
+        const Coefficient coefficient = mCoefficients[i];
+
+        for (unsigned var = 0; var < NVars; ++var)
         {
-            throw "Overflow in integration occurred";
+            const uint64_t unit = uint64_t(1) << variableShift(var);
+            if (!degreeDifferenceUnderflows(degree, unit))
+            {
+                res[var].pushBack(degree - unit, Coefficient(variableDegree(degree, var)) * coefficient);
+            }
         }
     }
 
     return res;
 }
 
-Polynomial Polynomial::integralZ() const
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient> BasicPolynomial<NVars, Bits, Coefficient>::fromIntegerPolynomial(const BasicPolynomial<NVars, Bits>& p)
+    requires (!IsFloatingPoint)
 {
-    Polynomial res;
+    if (p.isDense()) return fromIntegerPolynomial(p.sparseCopy());
 
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    BasicPolynomial res;
+    res.reserve(p.size());
+    for (size_t i = 0; i < p.size(); ++i)
     {
-        uint16_t degree = (*it).z();
-        if (degree < UINT16_MAX)
+        const double c = p.mCoefficients[i];
+        if (c != std::trunc(c) || std::abs(c) >= 9223372036854775808.0) // 2^63
         {
-            res.mMonomials.pushBack(
-                Monomial((*it).coefficient() / static_cast<double>(degree + 1), (*it).w(), (*it).x(), (*it).y(), (*it).z() + 1)
-            );
-        } else
+            throw std::invalid_argument(__FUNCTION__ ": coefficients must be integers less than 2^63 in absolute value.");
+        }
+
+        // при приведении по модулю коэффициент может обратиться в ноль
+        const Coefficient residue(static_cast<int64_t>(c));
+        if (residue != Coefficient())
         {
-            throw "Overflow in integration occurred";
+            res.pushBack(p.mDegrees[i], residue);
         }
     }
 
     return res;
 }
 
-Polynomial Polynomial::integralW() const
+namespace
 {
-    Polynomial res;
-
-    for (auto it = mMonomials.begin(); it != mMonomials.end(); ++it)
+    size_t skipSpaces(std::string_view str, size_t offset) noexcept
     {
-        uint16_t degree = (*it).w();
-        if (degree < UINT16_MAX)
-        {
-            res.mMonomials.pushBack(
-                Monomial((*it).coefficient() / static_cast<double>(degree + 1), (*it).w() + 1, (*it).x(), (*it).y(), (*it).z())
-            );
-        } else
+        while (offset < str.size() && std::isspace(static_cast<unsigned char>(str[offset])))
         {
-            throw "Overflow in integration occurred";
+            ++offset;
         }
+        return offset;
     }
 
-    return res;
+    bool isDigit(char c) noexcept
+    {
+        return c >= '0' && c <= '9';
+    }
 }
 
-std::variant<Polynomial::Monomial, SyntaxError> Polynomial::parseMonomial(const std::string& str, size_t& offset)
+// Пробелы допускаются между любыми частями монома, но не внутри чисел
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+std::variant<typename BasicPolynomial<NVars, Bits, Coefficient>::ParsedMonomial, SyntaxError> BasicPolynomial<NVars, Bits, Coefficient>::parseMonomial(std::string_view str, size_t& offset)
 {
-    std::string valid = "+-.1234567890wxyz";
-    if (valid.find(str[offset]) == std::string::npos)
+    auto isVariable = [](char c) { return c >= variableName(0) && c <= variableName(NVars - 1); };
+
+    if (std::string_view("+-.1234567890").find(str[offset]) == std::string_view::npos && !isVariable(str[offset]))
     {
         return SyntaxError{ offset, "Unexpected symbol" };
     }
 
-    std::string coefficient;
-    if (str[offset] == '+') ++offset;
-    while (offset < str.size() && (str[offset] == '-' || str[offset] == '.' || (str[offset] >= '0' && str[offset] <= '9')))
+    Coefficient coefficient = Coefficient(1);
+    if (str[offset] == '+') offset = skipSpaces(str, offset + 1);
+    if (offset < str.size() && str[offset] == '-')
     {
-        coefficient.push_back(str[offset]);
-        ++offset;
+        coefficient = Coefficient(-1);
+        offset = skipSpaces(str, offset + 1);
+
+        if (offset < str.size() && str[offset] == '-')
+        {
+            return SyntaxError{ offset + 1, "Invalid coefficient!" };
+        }
     }
 
-    double coefd;
-    if (coefficient == "-") coefd = -1.0;
-    else if (coefficient.size() == 0) coefd = 1.0;
-    else
+    if (offset < str.size() && (isDigit(str[offset]) || str[offset] == '.'))
     {
-        size_t coefl = 0;
-        try
+        size_t end = offset;
+        while (end < str.size() && (isDigit(str[end]) || str[end] == '.')) ++end;
+
+        if constexpr (IsFloatingPoint)
         {
-            coefd = std::stod(coefficient, &coefl);
-        }
-        catch (...)
+            double value;
+            auto [ptr, ec] = std::from_chars(str.data() + offset, str.data() + end, value);
+            if (ec != std::errc() || ptr != str.data() + end)
+            {
+                return SyntaxError{ skipSpaces(str, end), "Invalid coefficient!" };
+            }
+
+            coefficient *= value;
+        } else
         {
-            return SyntaxError{ offset, "Invalid coefficient!" };
+            // вычет принимает только целую запись: число любой длины приводится по модулю по цифрам
+            Coefficient value;
+            for (size_t i = offset; i < end; ++i)
+            {
+                if (str[i] == '.')
+                {
+                    return SyntaxError{ skipSpaces(str, end), "Invalid coefficient!" };
+                }
+                value = value * Coefficient(10) + Coefficient(str[i] - '0');
+            }
+
+            coefficient *= value;
         }
-        if (coefl != coefficient.size()) return SyntaxError{ offset, "Invalid coefficient!" };
+        offset = skipSpaces(str, end);
     }
 
-    uint16_t powers[4]{};
+    Exponents powers{};
 
-    while (offset < str.size() && (str[offset] == 'w' || str[offset] == 'x' || str[offset] == 'y' || str[offset] == 'z'))
+    while (offset < str.size() && isVariable(str[offset]))
     {
-        uint16_t& p = powers[str[offset] - 'w'];
+        uint32_t& p = powers[str[offset] - variableName(0)];
         if (p != 0)
         {
-            return SyntaxError{ offset,"Variables in monomes should be mentioned no more than once." };
+            return SyntaxError{ offset, "Variables in monomes should be mentioned no more than once." };
         }
 
         p = 1;
-        ++offset;
-
-        if (offset == str.size()) break;
-        if (str[offset] == '^')
-        {
-            ++offset;
-            if (offset == str.size()) break;
-        }
+        offset = skipSpaces(str, offset + 1);
 
-        std::string power;
-        while (offset < str.size() && (str[offset] >= '0' && str[offset] <= '9'))
-        {
-            power.push_back(str[offset++]);
-        }
+        if (offset < str.size() && str[offset] == '^') offset = skipSpaces(str, offset + 1);
 
-        if (power.size())
+        if (offset < str.size() && isDigit(str[offset]))
         {
-            uint32_t poweri;
+            size_t end = offset;
+            while (end < str.size() && isDigit(str[end])) ++end;
 
-            try
+            uint64_t power;
+            auto [ptr, ec] = std::from_chars(str.data() + offset, str.data() + end, power);
+            offset = skipSpaces(str, end);
+            if (ec != std::errc() || power > MaxDegree)
             {
-                poweri = std::stoul(power);
-            }
-            catch (...)
-            {
-                return SyntaxError{ offset, "Too big power! Maximum supported power is 65535" };
+                return SyntaxError{ offset, "Too big power! Maximum supported power is " + std::to_string(MaxDegree) };
             }
 
-            if (poweri > UINT16_MAX) return SyntaxError{ offset, "Too big power! Maximum supported power is 65535" };
-            p = poweri;
+            p = static_cast<uint32_t>(power);
         }
     }
 
-    return Monomial(coefd, powers[0], powers[1], powers[2], powers[3]);
+    return ParsedMonomial{ packDegree(powers), coefficient, offset };
 }
 
-std::variant<Polynomial, SyntaxError> Polynomial::parsePolynomial(const std::string& str)
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+std::variant<BasicPolynomial<NVars, Bits, Coefficient>, SyntaxError> BasicPolynomial<NVars, Bits, Coefficient>::parsePolynomial(std::string_view str)
 {
-    std::string nospaces;
-    std::vector<size_t> originalIndices;
+    // Мономы собираются в порядке записи и сортируются по степени один раз в конце
+    std::vector<ParsedMonomial> monomials;
 
-    for (size_t i = 0; i < str.size(); ++i)
+    // Позиция конца первого по записи повтора степени или npos
+    auto findRepeat = [&monomials]()
     {
-        if (!isspace(str[i]))
+        std::stable_sort(monomials.begin(), monomials.end(), [](const ParsedMonomial& a, const ParsedMonomial& b)
+        {
+            return a.degree > b.degree;
+        });
+
+        size_t repeatEnd = std::string_view::npos;
+        for (size_t i = 1; i < monomials.size(); ++i)
         {
-            nospaces.push_back(str[i]);
-            originalIndices.push_back(i);
+            if (monomials[i].degree == monomials[i - 1].degree)
+            {
+                repeatEnd = std::min(repeatEnd, monomials[i].end);
+            }
         }
-    }
-    originalIndices.push_back(str.size());
+        return repeatEnd;
+    };
+    const char* repeatMessage = "A polynomial must contain no more than one monomial of each degree.";
 
-    std::map<uint64_t, Monomial> monomials;
-    size_t offset = 0;
-    while (offset < nospaces.size())
+    size_t offset = skipSpaces(str, 0);
+    while (offset < str.size())
     {
-        auto res = parseMonomial(nospaces, offset);
-        if (res.index())
+        auto res = parseMonomial(str, offset);
+        if (!res.index())
         {
-            SyntaxError err = std::get<SyntaxError>(res);
-            err.pos = originalIndices[err.pos];
-            return err;
-        }
-        Monomial m = std::get<Monomial>(res);
+            const ParsedMonomial& m = std::get<ParsedMonomial>(res);
+            if (m.coefficient != Coefficient())
+            {
+                monomials.push_back(m);
+            }
 
-        if (m.coefficient() == 0.0) continue;
+            // мономы разделяются знаком: "2 3x" и "x2 3" - ошибка, а не сумма соседних мономов
+            if (offset < str.size() && str[offset] != '+' && str[offset] != '-')
+            {
+                res = SyntaxError{ offset, "Expected '+' or '-' between monomials." };
+            }
+        }
 
-        if (monomials.count(m.degree()))
+        if (res.index())
         {
-            return SyntaxError{ originalIndices[offset], "A polynomial must contain no more than one monomial of each degree." };
+            // повтор, встретившийся раньше синтаксической ошибки, сообщается первым
+            size_t repeatEnd = findRepeat();
+            if (repeatEnd != std::string_view::npos)
+            {
+                return SyntaxError{ repeatEnd, repeatMessage };
+            }
+            return std::get<SyntaxError>(std::move(res));
         }
+    }
 
-        monomials[m.degree()] = m;
+    size_t repeatEnd = findRepeat();
+    if (repeatEnd != std::string_view::npos)
+    {
+        return SyntaxError{ repeatEnd, repeatMessage };
     }
 
-    Polynomial p;
-    for (auto it = monomials.rbegin(); it != monomials.rend(); ++it)
+    BasicPolynomial p;
+    p.reserve(monomials.size());
+    for (const ParsedMonomial& m : monomials)
     {
-        p.mMonomials.pushBack(it->second);
+        p.pushBack(m.degree, m.coefficient);
     }
+    p.chooseRepresentation();
 
     return p;
 }
 
-Polynomial::Polynomial(double num)
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>::BasicPolynomial(Coefficient num)
+{
+    pushBack(0, num);
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>::BasicPolynomial(const BasicPolynomial& other) :
+    mDegrees(other.mDegrees), mCoefficients(other.mCoefficients), mBox(other.mBox), mEvaluationPlan(other.mEvaluationPlan.load())
+{
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>::BasicPolynomial(BasicPolynomial&& other) noexcept :
+    mDegrees(std::move(other.mDegrees)), mCoefficients(std::move(other.mCoefficients)), mBox(std::exchange(other.mBox, DenseBox())),
+    mEvaluationPlan(other.mEvaluationPlan.exchange(nullptr))
+{
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>& BasicPolynomial<NVars, Bits, Coefficient>::operator=(const BasicPolynomial& other)
+{
+    if (this != &other)
+    {
+        mDegrees = other.mDegrees;
+        mCoefficients = other.mCoefficients;
+        mBox = other.mBox;
+        mEvaluationPlan.store(other.mEvaluationPlan.load());
+    }
+
+    return *this;
+}
+
+template <unsigned NVars, unsigned Bits, typename Coefficient>
+BasicPolynomial<NVars, Bits, Coefficient>& BasicPolynomial<NVars, Bits, Coefficient>::operator=(BasicPolynomial&& other)
 {
-    Monomial m(num, 0, 0, 0, 0);
-    mMonomials.pushBack(m);
+    if (this != &other)
+    {
+        mDegrees = std::move(other.mDegrees);
+        mCoefficients = std::move(other.mCoefficients);
+        mBox = std::exchange(other.mBox, DenseBox());
+        mEvaluationPlan.store(other.mEvaluationPlan.exchange(nullptr));
+    }
+
+    return *this;
 }
+
+template class BasicPolynomial<4, 16>;
+template class BasicPolynomial<8, 8>;
+template class BasicPolynomial<2, 32>;
+template class BasicPolynomial<4, 16, ModInt<ModularPrime1>>;
+template class BasicPolynomial<4, 16, ModInt<ModularPrime2>>;
+template class BasicPolynomial<4, 16, ModInt<ModularPrime3>>;
@@ -1,4 +1,7 @@
 #include <table.h>
+#include <algorithm>
+#include <bit>
+#include <cstdint>
 
 #define DEFAULT_ORDERED_TABLE_SIZE 4
 
@@ -6,27 +9,27 @@
 
 LinearArrTable::LinearArrTable() {}
 
-void LinearArrTable::addPolynomial(const std::string& polName, const Polynomial& pol)
+void LinearArrTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
 {
-    if (findPolynomial(polName) == std::nullopt)
-        mTable.push_back({ polName, pol });
+    if (findPolynomial(polName) == nullptr)
+        mTable.push_back({ polName, std::move(pol) });
     else
         throw "There already is a polynomial with that name";
 }
 
-std::optional<Polynomial> LinearArrTable::findPolynomial(const std::string& polName)
+PolynomialHandle LinearArrTable::findPolynomial(std::string_view polName)
 {
-    for (auto rec : mTable)
+    for (const auto& rec : mTable)
         if (rec.key == polName)
             return rec.value;
-    return std::nullopt;
+    return nullptr;
 }
 
-void LinearArrTable::delPolynomial(const std::string& polName)
+void LinearArrTable::delPolynomial(std::string_view polName)
 {
     for (int i = 0; i < mTable.size(); i++)
     {
-        Pol rec = mTable[i];
+        const Pol& rec = mTable[i];
         if (rec.key == polName)
         {
             mTable.erase(std::next(mTable.begin(), i));
@@ -45,9 +48,9 @@ bool LinearArrTable::empty()
     return mTable.empty();
 }
 
-std::vector<std::pair< std::string, Polynomial>> LinearArrTable::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> LinearArrTable::getPolynomials()
 {
-    std::vector<std::pair< std::string, Polynomial>> result(mTable.size());
+    std::vector<std::pair< std::string, PolynomialHandle>> result(mTable.size());
     for (int i = 0; i < mTable.size(); i++)
     {
         result[i].first = mTable[i].key;
@@ -60,7 +63,7 @@ std::vector<std::pair< std::string, Polynomial>> LinearArrTable::getPolynomials(
 
 LinearListTable::LinearListTable() : pFirst(nullptr), mTableSize(0) {}
 
-std::optional<Polynomial> LinearListTable::findPolynomial(const std::string& polName)
+PolynomialHandle LinearListTable::findPolynomial(std::string_view polName)
 {
     Node* p = pFirst;
     while (p)
@@ -71,27 +74,27 @@ std::optional<Polynomial> LinearListTable::findPolynomial(const std::string& pol
         }
         p = p->pNext;
     }
-    return std::nullopt;
+    return nullptr;
 }
 
-void LinearListTable::addPolynomial(const std::string& polName, const Polynomial& pol)
+void LinearListTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
 {
-    if (findPolynomial(polName) != std::nullopt) // uniqueness check
+    if (findPolynomial(polName) != nullptr) // uniqueness check
         throw "There already is a polynomial with that name";
     mTableSize++;
     Node* p = pFirst;
     if (!p)
     {
-        pFirst = new Node{ polName, pol, nullptr };
+        pFirst = new Node{ polName, std::move(pol), nullptr };
         return;
     }
     while (p->pNext)
         p = p->pNext;
 
-    p->pNext = new Node{ polName, pol, nullptr };
+    p->pNext = new Node{ polName, std::move(pol), nullptr };
 }
 
-void LinearListTable::delPolynomial(const std::string& polName)
+void LinearListTable::delPolynomial(std::string_view polName)
 {
     Node* p = pFirst;
     if (!pFirst) return;
@@ -138,9 +141,9 @@ LinearListTable::~LinearListTable()
     }
 }
 
-std::vector<std::pair< std::string, Polynomial>> LinearListTable::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> LinearListTable::getPolynomials()
 {
-    std::vector<std::pair< std::string, Polynomial>> result(mTableSize);
+    std::vector<std::pair< std::string, PolynomialHandle>> result(mTableSize);
 
     Node* p = pFirst;
     int i = 0;
@@ -157,9 +160,9 @@ std::vector<std::pair< std::string, Polynomial>> LinearListTable::getPolynomials
 OrderedTable::OrderedTable()
 {}
 
-std::optional<Polynomial> OrderedTable::findPolynomial(const std::string& polName)
+PolynomialHandle OrderedTable::findPolynomial(std::string_view polName)
 {
-    if (mTable.size() == 0) return std::nullopt;
+    if (mTable.size() == 0) return nullptr;
     int i = mTable.size() / 2;
     int leftBorder = 0;
     int rightBorder = mTable.size() - 1;
@@ -178,12 +181,12 @@ std::optional<Polynomial> OrderedTable::findPolynomial(const std::string& polNam
     }
     if (mTable[i].key == polName)
         return mTable[i].value;
-    return std::nullopt;
+    return nullptr;
 }
 
-void OrderedTable::addPolynomial(const std::string& polName, const Polynomial& pol)
+void OrderedTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
 {
-    if (findPolynomial(polName) != std::nullopt) // uniqueness check
+    if (findPolynomial(polName) != nullptr) // uniqueness check
         throw "There already is a polynomial with that name";
     int i = mTable.size() / 2;
     int leftBorder = 0;
@@ -201,16 +204,16 @@ void OrderedTable::addPolynomial(const std::string& polName, const Polynomial& p
         }
     }
     if (mTable.size() == 0)
-        mTable.push_back({ polName, pol });
+        mTable.push_back({ polName, std::move(pol) });
     else if (mTable[i].key > polName)
-        mTable.insert(mTable.begin() + i, { polName, pol });
+        mTable.insert(mTable.begin() + i, { polName, std::move(pol) });
     else if (mTable[i].key < polName)
-        mTable.insert(mTable.begin() + i + 1, { polName, pol });
+        mTable.insert(mTable.begin() + i + 1, { polName, std::move(pol) });
 }
 
-void OrderedTable::delPolynomial(const std::string& polName)
+void OrderedTable::delPolynomial(std::string_view polName)
 {
-    if (findPolynomial(polName) == std::nullopt) return; // uniqueness check
+    if (findPolynomial(polName) == nullptr) return; // uniqueness check
     int i = mTable.size() / 2;
     int leftBorder = 0;
     int rightBorder = mTable.size() - 1;
@@ -239,9 +242,9 @@ bool OrderedTable::empty()
     return mTable.size() == 0;
 }
 
-std::vector<std::pair< std::string, Polynomial>> OrderedTable::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> OrderedTable::getPolynomials()
 {
-    std::vector<std::pair< std::string, Polynomial>> result(mTable.size());
+    std::vector<std::pair< std::string, PolynomialHandle>> result(mTable.size());
     for (int i = 0; i < mTable.size(); i++)
     {
         result[i].first = mTable[i].key;
@@ -257,22 +260,22 @@ TreeTable::TreeTable()
 
 }
 
-void TreeTable::addPolynomial(const std::string& polName, const Polynomial& pol)
+void TreeTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
 {
     if (mTree.find(polName) != std::nullopt)
     {
         throw std::runtime_error("Polynomial already exist");
     }
 
-    mTree.insert(polName, pol);
+    mTree.insert(polName, std::move(pol));
 }
 
-std::optional<Polynomial> TreeTable::findPolynomial(const std::string& polName)
+PolynomialHandle TreeTable::findPolynomial(std::string_view polName)
 {
-    return mTree.find(polName);
+    return mTree.find(polName).value_or(nullptr);
 }
 
-void TreeTable::delPolynomial(const std::string& polName)
+void TreeTable::delPolynomial(std::string_view polName)
 {
     mTree.erase(polName);
 }
@@ -289,93 +292,129 @@ bool TreeTable::empty()
 
 }
 
-std::vector<std::pair< std::string, Polynomial>> TreeTable::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> TreeTable::getPolynomials()
 {
-    return mTree.toVector();
+    std::vector<std::pair< std::string, PolynomialHandle>> result;
+    for (const auto& [key, value] : mTree.toVector())
+        result.emplace_back(key, value);
+    return result;
 }
 
 // *** OpenAddressHashTable ***
 
-OpenAddressHashTable::OpenAddressHashTable() : mTableSize(28), mCurrentSize(0), step(3) // mTableSize and step are mutually prime numbers
+#define DEFAULT_OPEN_ADDRESS_TABLE_SIZE 32 // must be a power of two
+
+OpenAddressHashTable::OpenAddressHashTable() : mCurrentSize(0)
 {
-    mTable.resize(mTableSize, { }); // int status initialized with zero
+    mTable.resize(DEFAULT_OPEN_ADDRESS_TABLE_SIZE);
 }
 
-unsigned int OpenAddressHashTable::hashFunc(const std::string& key) //polynomial hash function
+static size_t stringHash(std::string_view key) // FNV-1a with a final mix, so both low and high bits depend on every char
 {
-    long long h = 0, pow = 1;
-    long long p = 31, m = 1e9 + 7;
+    uint64_t h = 14695981039346656037ull;
     for (char c : key)
     {
-        h = (h + pow * (int)(c - 'a' + 1)) % m;
-        pow = (pow * p) % m;
+        h ^= (unsigned char)c;
+        h *= 1099511628211ull;
     }
-
-    return h % mTableSize;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    return (size_t)h;
 }
 
-void OpenAddressHashTable::addPolynomial(const std::string& polName, const Polynomial& pol)
+size_t OpenAddressHashTable::hashFunc(std::string_view key)
 {
-    if (findPolynomial(polName) != std::nullopt)
-        throw "There already is a polynomial with that name";
-    mCurrentSize++;
+    return stringHash(key);
+}
 
-    if (mCurrentSize / mTableSize > 0.5) // repacking
+size_t OpenAddressHashTable::findIndex(std::string_view key) const
+{
+    const size_t mask = mTable.size() - 1;
+    const size_t hash = hashFunc(key);
+    size_t ind = hash & mask;
+    // a key cannot lie past a slot whose own key is closer to home than the key would be there
+    for (int distance = 0; mTable[ind].distance >= distance; distance++)
     {
-        mTableSize *= 2;
-        std::vector<Node> helpTable;
-        helpTable.resize(mTableSize, { });
-        for (int i = 0; i < mTableSize / 2; i++)
-        {
-            if (mTable[i].status == 1)
-            {
-                int ind = hashFunc(mTable[i].key);
-                while (helpTable[ind].status != 0)
-                    ind += step;
-                helpTable[ind] = mTable[i]; // hashFunc uses mTableSize
-            }
-        }
-        mTable = helpTable;
+        if (mTable[ind].hash == hash && mTable[ind].key == key) // stored hash skips most string compares
+            return ind;
+        ind = (ind + 1) & mask;
     }
+    return mTable.size();
+}
 
-    int ind = hashFunc(polName);
-    while (mTable[ind].status != 0 && mTable[ind].status != -1)
+void OpenAddressHashTable::insertNode(Node node)
+{
+    const size_t mask = mTable.size() - 1;
+    size_t ind = node.hash & mask;
+    node.distance = 0;
+    while (mTable[ind].distance != -1)
     {
-        ind += step;
-        ind %= mTableSize;
+        if (mTable[ind].distance < node.distance) // take the place of a richer key and carry it on
+            std::swap(mTable[ind], node);
+        ind = (ind + 1) & mask;
+        node.distance++;
     }
-    mTable[ind].key = polName;
-    mTable[ind].value = pol;
-    mTable[ind].status = 1;
+    mTable[ind] = std::move(node);
 }
 
-std::optional<Polynomial> OpenAddressHashTable::findPolynomial(const std::string& polName)
+void OpenAddressHashTable::rehash(size_t capacity)
 {
-    int ind = hashFunc(polName);
-    while (mTable[ind].status != 0)
+    std::vector<Node> oldTable(capacity);
+    mTable.swap(oldTable);
+    for (Node& node : oldTable)
     {
-        if (mTable[ind].key == polName && mTable[ind].status != -1) // hotfixed by Z
-            return mTable[ind].value;
-        ind += step;
-        ind %= mTableSize;
+        if (node.distance != -1)
+            insertNode(std::move(node)); // stored hashes: the keys are not hashed again
     }
-    return std::nullopt;
 }
 
-void OpenAddressHashTable::delPolynomial(const std::string& polName)
+void OpenAddressHashTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
 {
-    int ind = hashFunc(polName);
-    while (mTable[ind].status != 0)
+    if (findIndex(polName) != mTable.size())
+        throw "There already is a polynomial with that name";
+
+    if ((mCurrentSize + 1) * 4 > mTable.size() * 3) // keep the load factor at most 3/4
+        rehash(mTable.size() * 2);
+
+    insertNode({ 0, hashFunc(polName), polName, std::move(pol) });
+    mCurrentSize++;
+}
+
+PolynomialHandle OpenAddressHashTable::findPolynomial(std::string_view polName)
+{
+    size_t ind = findIndex(polName);
+    if (ind == mTable.size())
+        return nullptr;
+    return mTable[ind].value;
+}
+
+void OpenAddressHashTable::delPolynomial(std::string_view polName)
+{
+    size_t ind = findIndex(polName);
+    if (ind == mTable.size())
+        return;
+
+    // backward shift: the following keys of the cluster move one slot closer to home
+    const size_t mask = mTable.size() - 1;
+    size_t next = (ind + 1) & mask;
+    while (mTable[next].distance > 0)
     {
-        if (mTable[ind].status == 1 && mTable[ind].key == polName)
-        {
-            mTable[ind].status = -1;
-            mCurrentSize--;
-            break;
-        }
-        ind += step;
-        ind %= mTableSize;
+        mTable[ind] = std::move(mTable[next]);
+        mTable[ind].distance--;
+        ind = next;
+        next = (next + 1) & mask;
     }
+    mTable[ind] = Node{};
+    mCurrentSize--;
+}
+
+size_t OpenAddressHashTable::maxProbeLength() const
+{
+    int result = 0;
+    for (const Node& node : mTable)
+        result = std::max(result, node.distance);
+    return result;
 }
 
 unsigned int OpenAddressHashTable::size()
@@ -390,13 +429,13 @@ bool OpenAddressHashTable::empty()
 
 }
 
-std::vector<std::pair< std::string, Polynomial>> OpenAddressHashTable::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> OpenAddressHashTable::getPolynomials()
 {
-    std::vector<std::pair< std::string, Polynomial>> result(mCurrentSize);
+    std::vector<std::pair< std::string, PolynomialHandle>> result(mCurrentSize);
     int j = 0;
-    for (int i = 0; i < mTableSize; i++)
+    for (int i = 0; i < mTable.size(); i++)
     {
-        if (mTable[i].status == 1)
+        if (mTable[i].distance != -1)
         {
             result[j].first = mTable[i].key;
             result[j].second = mTable[i].value;
@@ -413,7 +452,7 @@ SeparateChainingHashTable::SeparateChainingHashTable() : mTableSize(15), mCurren
     mTable.resize(mTableSize, nullptr);
 }
 
-unsigned int SeparateChainingHashTable::hashFunc(const std::string& key) //polynomial hash function
+unsigned int SeparateChainingHashTable::hashFunc(std::string_view key) //polynomial hash function
 {
     long long h = 0, pow = 1;
     long long p = 31, m = 1e9 + 7;
@@ -426,23 +465,23 @@ unsigned int SeparateChainingHashTable::hashFunc(const std::string& key) //polyn
     return h % mTableSize;
 }
 
-void SeparateChainingHashTable::addPolynomial(const std::string& polName, const Polynomial& pol)
+void SeparateChainingHashTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
 {
-    if (findPolynomial(polName) != std::nullopt)
+    if (findPolynomial(polName) != nullptr)
         throw "There already is a polynomial with that name";
     mCurrentSize++;
     if (!mTable[hashFunc(polName)])
     {
-        mTable[hashFunc(polName)] = new Node{ polName, pol, nullptr };
+        mTable[hashFunc(polName)] = new Node{ polName, std::move(pol), nullptr };
         return;
     }
     Node* p = mTable[hashFunc(polName)];
     while (p->pNextInChain)
         p = p->pNextInChain;
-    p->pNextInChain = new Node{ polName, pol, nullptr };
+    p->pNextInChain = new Node{ polName, std::move(pol), nullptr };
 }
 
-std::optional<Polynomial> SeparateChainingHashTable::findPolynomial(const std::string& polName)
+PolynomialHandle SeparateChainingHashTable::findPolynomial(std::string_view polName)
 {
     Node* p = mTable[hashFunc(polName)];
     while (p)
@@ -453,10 +492,10 @@ std::optional<Polynomial> SeparateChainingHashTable::findPolynomial(const std::s
         }
         p = p->pNextInChain;
     }
-    return std::nullopt;
+    return nullptr;
 }
 
-void SeparateChainingHashTable::delPolynomial(const std::string& polName)
+void SeparateChainingHashTable::delPolynomial(std::string_view polName)
 {
     int ind = hashFunc(polName);
     if (!mTable[ind]) return;
@@ -494,9 +533,9 @@ bool SeparateChainingHashTable::empty()
 
 }
 
-std::vector<std::pair< std::string, Polynomial>> SeparateChainingHashTable::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> SeparateChainingHashTable::getPolynomials()
 {
-    std::vector<std::pair< std::string, Polynomial>> result(mCurrentSize);
+    std::vector<std::pair< std::string, PolynomialHandle>> result(mCurrentSize);
     int j = 0;
     for (int i = 0; i < mTableSize; i++)
     {
@@ -512,11 +551,213 @@ std::vector<std::pair< std::string, Polynomial>> SeparateChainingHashTable::getP
     return result;
 }
 
+// *** SwissHashTable ***
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SWISS_TABLE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace
+{
+    const int8_t SwissEmpty = -128;  // 0b10000000
+    const int8_t SwissDeleted = -2;  // 0b11111110, full slots are 0..127, so both are negative
+    const size_t SwissGroupSize = 16;
+
+    // Control bytes of one group; matches return a bit mask with bit i set for slot i of the group
+    class SwissGroup
+    {
+    public:
+        explicit SwissGroup(const int8_t* pControl)
+        {
+#ifdef SWISS_TABLE_SSE2
+            mControl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pControl));
+#else
+            std::copy(pControl, pControl + SwissGroupSize, mControl);
+#endif
+        }
+
+        uint32_t match(int8_t tag) const
+        {
+#ifdef SWISS_TABLE_SSE2
+            return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(tag), mControl));
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < SwissGroupSize; i++)
+                mask |= uint32_t(mControl[i] == tag) << i;
+            return mask;
+#endif
+        }
+
+        uint32_t matchEmpty() const
+        {
+            return match(SwissEmpty);
+        }
+
+        uint32_t matchEmptyOrDeleted() const
+        {
+#ifdef SWISS_TABLE_SSE2
+            return _mm_movemask_epi8(mControl); // sign bits
+#else
+            uint32_t mask = 0;
+            for (size_t i = 0; i < SwissGroupSize; i++)
+                mask |= uint32_t(mControl[i] < 0) << i;
+            return mask;
+#endif
+        }
+
+    private:
+#ifdef SWISS_TABLE_SSE2
+        __m128i mControl;
+#else
+        int8_t mControl[SwissGroupSize];
+#endif
+    };
+
+    int8_t swissTag(size_t hash) // low 7 bits select the tag, the rest select the group
+    {
+        return int8_t(hash & 0x7F);
+    }
+}
+
+SwissHashTable::SwissHashTable() : mCurrentSize(0), mDeleted(0)
+{
+    mControl.resize(SwissGroupSize, SwissEmpty);
+    mSlots.resize(SwissGroupSize);
+}
+
+size_t SwissHashTable::hashFunc(std::string_view key)
+{
+    return stringHash(key);
+}
+
+size_t SwissHashTable::findIndex(std::string_view key) const
+{
+    const size_t hash = hashFunc(key);
+    const int8_t tag = swissTag(hash);
+    const size_t groupMask = mSlots.size() / SwissGroupSize - 1;
+    size_t group = (hash >> 7) & groupMask;
+    // triangular probing over groups visits every group; the load factor keeps an empty slot somewhere
+    for (size_t step = 1; ; step++)
+    {
+        SwissGroup controls(&mControl[group * SwissGroupSize]);
+        for (uint32_t mask = controls.match(tag); mask != 0; mask &= mask - 1)
+        {
+            size_t ind = group * SwissGroupSize + std::countr_zero(mask);
+            if (mSlots[ind].key == key)
+                return ind;
+        }
+        if (controls.matchEmpty() != 0) // the key would have been placed here
+            return mSlots.size();
+        group = (group + step) & groupMask;
+    }
+}
+
+size_t SwissHashTable::findFreeSlot(size_t hash) const
+{
+    const size_t groupMask = mSlots.size() / SwissGroupSize - 1;
+    size_t group = (hash >> 7) & groupMask;
+    for (size_t step = 1; ; step++)
+    {
+        uint32_t mask = SwissGroup(&mControl[group * SwissGroupSize]).matchEmptyOrDeleted();
+        if (mask != 0)
+            return group * SwissGroupSize + std::countr_zero(mask);
+        group = (group + step) & groupMask;
+    }
+}
+
+void SwissHashTable::rehash(size_t capacity)
+{
+    std::vector<int8_t> oldControl(capacity, SwissEmpty);
+    std::vector<Slot> oldSlots(capacity);
+    mControl.swap(oldControl);
+    mSlots.swap(oldSlots);
+    mDeleted = 0;
+    for (size_t i = 0; i < oldSlots.size(); i++)
+    {
+        if (oldControl[i] < 0)
+            continue;
+        size_t hash = hashFunc(oldSlots[i].key);
+        size_t ind = findFreeSlot(hash);
+        mControl[ind] = swissTag(hash);
+        mSlots[ind] = std::move(oldSlots[i]);
+    }
+}
+
+void SwissHashTable::addPolynomial(const std::string& polName, PolynomialHandle pol)
+{
+    if (findIndex(polName) != mSlots.size())
+        throw "There already is a polynomial with that name";
+
+    // deleted slots also lengthen probes, so they count towards the 7/8 load factor
+    if ((mCurrentSize + mDeleted + 1) * 8 > mSlots.size() * 7)
+        rehash((mCurrentSize + 1) * 16 > mSlots.size() * 7 ? mSlots.size() * 2 : mSlots.size());
+
+    size_t hash = hashFunc(polName);
+    size_t ind = findFreeSlot(hash);
+    if (mControl[ind] == SwissDeleted)
+        mDeleted--;
+    mControl[ind] = swissTag(hash);
+    mSlots[ind] = { polName, std::move(pol) };
+    mCurrentSize++;
+}
+
+PolynomialHandle SwissHashTable::findPolynomial(std::string_view polName)
+{
+    size_t ind = findIndex(polName);
+    if (ind == mSlots.size())
+        return nullptr;
+    return mSlots[ind].value;
+}
+
+void SwissHashTable::delPolynomial(std::string_view polName)
+{
+    size_t ind = findIndex(polName);
+    if (ind == mSlots.size())
+        return;
+
+    // a group that still has an empty slot has never been full, so no probe went past it
+    // and the slot can become empty again instead of deleted
+    size_t group = ind / SwissGroupSize;
+    if (SwissGroup(&mControl[group * SwissGroupSize]).matchEmpty() != 0)
+    {
+        mControl[ind] = SwissEmpty;
+    } else
+    {
+        mControl[ind] = SwissDeleted;
+        mDeleted++;
+    }
+    mSlots[ind] = Slot{};
+    mCurrentSize--;
+}
+
+unsigned int SwissHashTable::size()
+{
+    return mCurrentSize;
+}
+
+bool SwissHashTable::empty()
+{
+    return mCurrentSize == 0;
+}
+
+std::vector<std::pair< std::string, PolynomialHandle>> SwissHashTable::getPolynomials()
+{
+    std::vector<std::pair< std::string, PolynomialHandle>> result;
+    result.reserve(mCurrentSize);
+    for (size_t i = 0; i < mSlots.size(); i++)
+    {
+        if (mControl[i] >= 0)
+            result.emplace_back(mSlots[i].key, mSlots[i].value);
+    }
+    return result;
+}
+
 // *** Aggregator ***
 
 Aggregator::Aggregator()
 {
-    mTables.resize(6, nullptr);
+    mTables.resize(7, nullptr);
 
     mTables[0] = new LinearArrTable();
     mTables[1] = new LinearListTable();
@@ -524,6 +765,7 @@ Aggregator::Aggregator()
     mTables[3] = new TreeTable();
     mTables[4] = new OpenAddressHashTable();
     mTables[5] = new SeparateChainingHashTable();
+    mTables[6] = new SwissHashTable();
 
     mCurrentTable = 0;
 }
@@ -548,26 +790,36 @@ void Aggregator::selectTable(const std::string& tableName)
     } else if (tableName == "seha")
     {
         mCurrentTable = 5;
+    } else if (tableName == "swis")
+    {
+        mCurrentTable = 6;
     } else
     {
         throw "Cannot select table " + tableName;
     }
 }
 
-std::optional<Polynomial> Aggregator::findPolynomial(const std::string& polName)
+PolynomialHandle Aggregator::findPolynomial(std::string_view polName)
 {
     return mTables[mCurrentTable]->findPolynomial(polName);
 }
 
 void Aggregator::addPolynomial(const std::string& polName, const Polynomial& pol)
 {
-    for (int i = 0; i < 6; i++)
+    addPolynomial(polName, std::make_shared<const Polynomial>(pol));
+}
+
+void Aggregator::addPolynomial(const std::string& polName, PolynomialHandle pol)
+{
+    if (pol == nullptr)
+        throw std::invalid_argument(__FUNCTION__ ": polynomial handle is null.");
+    for (int i = 0; i < mTables.size(); i++)
         mTables[i]->addPolynomial(polName, pol);
 }
 
-void Aggregator::delPolynomial(const std::string& polName)
+void Aggregator::delPolynomial(std::string_view polName)
 {
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < mTables.size(); i++)
         mTables[i]->delPolynomial(polName);
 }
 
@@ -581,7 +833,7 @@ bool Aggregator::empty()
     return size() == 0;
 }
 
-std::vector<std::pair< std::string, Polynomial>> Aggregator::getPolynomials()
+std::vector<std::pair< std::string, PolynomialHandle>> Aggregator::getPolynomials()
 {
     return mTables[mCurrentTable]->getPolynomials();
 }
@@ -150,6 +150,23 @@ TEST(ExprCompilerTest, can_compile_multiplication)
     EXPECT_EQ(std::get<Intr::Opcode>(p[2]), Intr::Opcode::MULT);
 }
 
+TEST(ExprCompilerTest, can_compile_power)
+{
+    Compiler::ExpressionCompiler c;
+    auto res = c.compileExpression(Lexer::Lexer("pol^3").getAllTokens());
+
+    EXPECT_TRUE(std::holds_alternative<Intr::Program>(res));
+
+    Intr::Program p = std::get<Intr::Program>(res);
+    EXPECT_EQ(p.size(), 3);
+    EXPECT_TRUE(std::holds_alternative<std::string>(p[0]));
+    EXPECT_EQ(std::get<std::string>(p[0]), "pol");
+    EXPECT_TRUE(std::holds_alternative<unsigned long>(p[1]));
+    EXPECT_EQ(std::get<unsigned long>(p[1]), 3);
+    EXPECT_TRUE(std::holds_alternative<Intr::Opcode>(p[2]));
+    EXPECT_EQ(std::get<Intr::Opcode>(p[2]), Intr::Opcode::POWER);
+}
+
 TEST(ExprCompilerTest, can_compile_calc)
 {
     Compiler::ExpressionCompiler c;
@@ -407,4 +424,41 @@ TEST(ExprCompilerTest, error_on_function_not_enough_params)
 
     EXPECT_TRUE(std::holds_alternative<SyntaxError>(res));
     EXPECT_EQ(std::get<SyntaxError>(res).pos, 10);
-}
\ No newline at end of file
+}
+
+TEST(ExprCompilerTest, can_compile_truncated_functions)
+{
+    Compiler::ExpressionCompiler c;
+    auto res = c.compileExpression(Lexer::Lexer("truncmul(x, pol, 3) + truncpow(y, 5, 4)").getAllTokens());
+
+    EXPECT_TRUE(std::holds_alternative<Intr::Program>(res));
+
+    Intr::Program p = std::get<Intr::Program>(res);
+    EXPECT_EQ(p.size(), 9);
+    EXPECT_TRUE(std::holds_alternative<std::string>(p[1]));
+    EXPECT_EQ(std::get<unsigned long>(p[2]), 3);
+    EXPECT_EQ(std::get<Intr::Opcode>(p[3]), Intr::Opcode::TRUNCMUL);
+    EXPECT_EQ(std::get<unsigned long>(p[5]), 5);
+    EXPECT_EQ(std::get<unsigned long>(p[6]), 4);
+    EXPECT_EQ(std::get<Intr::Opcode>(p[7]), Intr::Opcode::TRUNCPOW);
+    EXPECT_EQ(std::get<Intr::Opcode>(p[8]), Intr::Opcode::ADD);
+}
+
+TEST(ExprCompilerTest, error_on_truncated_power_with_polynomial_exponent)
+{
+    Compiler::ExpressionCompiler c;
+
+    auto res = c.compileExpression(Lexer::Lexer("truncpow(x, y, 4)").getAllTokens());
+    ASSERT_TRUE(std::holds_alternative<SyntaxError>(res));
+    EXPECT_EQ(std::get<SyntaxError>(res).pos, 0);
+    EXPECT_TRUE(std::holds_alternative<SyntaxError>(c.compileExpression(Lexer::Lexer("truncmul(x, y)").getAllTokens())));
+}
+
+TEST(ExprCompilerTest, error_on_truncated_functions_with_float_arguments)
+{
+    Compiler::ExpressionCompiler c;
+
+    EXPECT_TRUE(std::holds_alternative<SyntaxError>(c.compileExpression(Lexer::Lexer("truncmul(x, y, 2.5)").getAllTokens())));
+    EXPECT_TRUE(std::holds_alternative<SyntaxError>(c.compileExpression(Lexer::Lexer("truncpow(x, 2.5, 4)").getAllTokens())));
+    EXPECT_TRUE(std::holds_alternative<SyntaxError>(c.compileExpression(Lexer::Lexer("truncpow(x, 2, 4.0)").getAllTokens())));
+}
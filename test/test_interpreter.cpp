@@ -63,6 +63,20 @@ TEST(ExprInterpreterTest, can_execute_subtraction)
     EXPECT_EQ(std::get<Polynomial>(res), std::get<Polynomial>(Polynomial::fromString("123x54y12z12w - 40x - 50")));
 }
 
+TEST(ExprInterpreterTest, can_execute_chained_sum)
+{
+    Aggregator agg;
+    ExpressionInterpreter intr(&agg);
+    auto res = intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("-(y + 4) + x + 2y - (3x - z) - 2x*y + 3*(z - 1)").getAllTokens()
+        ))
+    );
+
+    EXPECT_TRUE(std::holds_alternative<Polynomial>(res));
+    EXPECT_EQ(std::get<Polynomial>(res), std::get<Polynomial>(Polynomial::fromString("-2x + y + 4z - 2xy - 7")));
+}
+
 TEST(ExprInterpreterTest, can_execute_multiplication)
 {
     Aggregator agg;
@@ -93,6 +107,20 @@ TEST(ExprInterpreterTest, can_execute_multiplication)
 //    EXPECT_EQ(agg.findPolynomial("mypol"), std::get<polynomial>(polynomial::fromString("6150x54y12z12w + 4920x55y12z12w")));
 //}
 
+TEST(ExprInterpreterTest, can_execute_power)
+{
+    Aggregator agg;
+    ExpressionInterpreter intr(&agg);
+    auto res = intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("(x + 1)^3 - 2").getAllTokens()
+        ))
+    );
+
+    EXPECT_TRUE(std::holds_alternative<Polynomial>(res));
+    EXPECT_EQ(std::get<Polynomial>(res), std::get<Polynomial>(Polynomial::fromString("x^3 + 3x^2 + 3x - 1")));
+}
+
 TEST(ExprInterpreterTest, can_execute_calc)
 {
     Aggregator agg;
@@ -145,4 +173,76 @@ TEST(ExprInterpreterTest, throw_on_unknown_polynomial)
             Lexer::Lexer("b = 2 * a").getAllTokens()
         ))
     ));
-}
\ No newline at end of file
+}
+
+TEST(ExprInterpreterTest, assigned_polynomial_outlives_evaluation_arena)
+{
+    Aggregator agg;
+    ExpressionInterpreter intr(&agg);
+    Polynomial expected = std::get<Polynomial>(Polynomial::fromString("x + y + z + w")).pow(6);
+
+    intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("mypol = (x + y + z + w)^6").getAllTokens()
+        ))
+    );
+    auto res = intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("mypol - (x + y + z + w)^6").getAllTokens()
+        ))
+    );
+
+    ASSERT_NE(agg.findPolynomial("mypol"), nullptr);
+    EXPECT_EQ(*agg.findPolynomial("mypol"), expected);
+    EXPECT_TRUE(std::holds_alternative<Polynomial>(res));
+    EXPECT_EQ(std::get<Polynomial>(res), Polynomial());
+}
+
+TEST(ExprInterpreterTest, can_execute_truncated_multiplication_and_power)
+{
+    Aggregator agg;
+    ExpressionInterpreter intr(&agg);
+    auto res = intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("truncmul(1 + x + y, 1 - x + y^2, 2) + truncpow(1 + x, 10, 2)").getAllTokens()
+        ))
+    );
+
+    EXPECT_TRUE(std::holds_alternative<Polynomial>(res));
+    EXPECT_EQ(std::get<Polynomial>(res), std::get<Polynomial>(Polynomial::fromString("2 + 10x + y - xy + 44x^2 + y^2")));
+}
+
+TEST(ExprInterpreterTest, operations_on_stored_polynomial_do_not_change_it)
+{
+    Aggregator agg;
+    ExpressionInterpreter intr(&agg);
+    Polynomial stored = std::get<Polynomial>(Polynomial::fromString("x^2y + 3z"));
+    agg.addPolynomial("p", stored);
+
+    auto res = intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("derx(p) + inty(p) - p * p - p").getAllTokens()
+        ))
+    );
+
+    EXPECT_TRUE(std::holds_alternative<Polynomial>(res));
+    EXPECT_EQ(std::get<Polynomial>(res), stored.derivative(1) + stored.integral(2) - stored * stored - stored);
+    EXPECT_EQ(*agg.findPolynomial("p"), stored);
+}
+
+TEST(ExprInterpreterTest, assigning_stored_polynomial_shares_it)
+{
+    Aggregator agg;
+    ExpressionInterpreter intr(&agg);
+    agg.addPolynomial("b", std::get<Polynomial>(Polynomial::fromString("x^2y + 3z")));
+
+    auto res = intr.execute(
+        std::get<Program>(ExpressionCompiler().compileExpression(
+            Lexer::Lexer("a = b").getAllTokens()
+        ))
+    );
+
+    EXPECT_TRUE(std::holds_alternative<Polynomial>(res));
+    ASSERT_NE(agg.findPolynomial("a"), nullptr);
+    EXPECT_EQ(agg.findPolynomial("a").get(), agg.findPolynomial("b").get());
+}
@@ -1,5 +1,7 @@
 #include "linked_list.h"
+#include <cstddef>
 #include <exception>
+#include <memory_resource>
 #include <gtest/gtest.h>
 
 TEST(LinkedListTest, can_create_with_default_constructor)
@@ -244,4 +246,32 @@ TEST(LinkedListTest, can_clear_list)
     EXPECT_EQ(list.size(), 0);
     EXPECT_THROW(list.front(), std::out_of_range);
     EXPECT_THROW(list.back(), std::out_of_range);
-}
\ No newline at end of file
+}
+
+TEST(LinkedListTest, allocates_nodes_from_given_resource)
+{
+    std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    LinkedList<int> list({ 1, 2, 3 }, &arena);
+    list.pushFront(0);
+
+    EXPECT_EQ(list.resource(), &arena);
+    EXPECT_EQ(list.size(), 4);
+    EXPECT_GE(reinterpret_cast<const std::byte*>(&list.front()), buffer);
+    EXPECT_LT(reinterpret_cast<const std::byte*>(&list.front()), buffer + sizeof(buffer));
+}
+
+TEST(LinkedListTest, move_assignment_between_resources_copies_elements)
+{
+    std::pmr::monotonic_buffer_resource arena;
+    LinkedList<int> source({ 1, 2, 3 }, &arena);
+    LinkedList<int> target;
+
+    target = std::move(source);
+
+    EXPECT_EQ(target.resource(), currentMemoryResource());
+    EXPECT_EQ(target.size(), 3);
+    EXPECT_EQ(target.back(), 3);
+    EXPECT_TRUE(source.empty());
+}
@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+#include <climits>
+#include <cmath>
+#include <sstream>
+#include "modular.h"
+#include "polynomial.h"
+
+using Mod1 = ModInt<ModularPrime1>;
+
+TEST(ModIntTest, can_do_arithmetic)
+{
+    Mod1 a(5), b(7);
+
+    EXPECT_EQ((a + b).value(), 12u);
+    EXPECT_EQ((a - b).value(), ModularPrime1 - 2);
+    EXPECT_EQ((a - b).signedValue(), -2);
+    EXPECT_EQ((a * b).value(), 35u);
+    EXPECT_EQ((-a).signedValue(), -5);
+}
+
+TEST(ModIntTest, reduces_large_and_negative_values)
+{
+    EXPECT_EQ(Mod1(ModularPrime1).value(), 0u);
+    EXPECT_EQ(Mod1(ModularPrime1 + 3).value(), 3u);
+    EXPECT_EQ(Mod1(-1).value(), ModularPrime1 - 1);
+    EXPECT_EQ(Mod1(INT64_MIN), Mod1(int64_t(-1) << 62) * Mod1(2));
+}
+
+TEST(ModIntTest, can_multiply_near_modulus)
+{
+    // (p - 1)^2 = 1 (mod p)
+    Mod1 a(ModularPrime1 - 1);
+
+    EXPECT_EQ((a * a).value(), 1u);
+}
+
+TEST(ModIntTest, can_divide)
+{
+    Mod1 a(123456789);
+    Mod1 b(987654321);
+
+    EXPECT_EQ((a * b.inverse() * b), a);
+    EXPECT_EQ(((a / b) * b), a);
+    EXPECT_EQ(Mod1(2).pow(62).value(), 57u); // 2^62 = 57 (mod 2^62 - 57)
+}
+
+TEST(CrtReconstructorTest, throws_when_moduli_are_invalid)
+{
+    EXPECT_THROW(CrtReconstructor({}), std::invalid_argument);
+    EXPECT_THROW(CrtReconstructor({ 10 }), std::invalid_argument);
+    EXPECT_THROW(CrtReconstructor({ ModularPrime1, ModularPrime1 }), std::invalid_argument);
+}
+
+TEST(CrtReconstructorTest, can_reconstruct_signed_values)
+{
+    CrtReconstructor crt({ 7, 11, 13 });
+
+    for (int x = -500; x <= 500; ++x)
+    {
+        uint64_t residues[] = { uint64_t((x % 7 + 7) % 7), uint64_t((x % 11 + 11) % 11), uint64_t((x % 13 + 13) % 13) };
+        EXPECT_EQ(crt.reconstruct(residues), static_cast<double>(x));
+    }
+}
+
+TEST(ModularPolynomialTest, can_parse_and_print)
+{
+    auto parsed = ModularPolynomial<ModularPrime1>::fromString("3x^2 - 5y + 7");
+    ASSERT_TRUE(std::holds_alternative<ModularPolynomial<ModularPrime1>>(parsed));
+
+    std::ostringstream modular, floating;
+    modular << std::get<ModularPolynomial<ModularPrime1>>(parsed);
+    floating << std::get<Polynomial>(Polynomial::fromString("3x^2 - 5y + 7"));
+
+    EXPECT_EQ(modular.str(), floating.str());
+}
+
+TEST(ModularPolynomialTest, reduces_long_integer_coefficients_when_parsing)
+{
+    auto p = std::get<ModularPolynomial<ModularPrime1>>(ModularPolynomial<ModularPrime1>::fromString("4611686018427387850x"));
+
+    EXPECT_EQ(p, std::get<ModularPolynomial<ModularPrime1>>(ModularPolynomial<ModularPrime1>::fromString("3x")));
+}
+
+TEST(ModularPolynomialTest, rejects_fractional_coefficients)
+{
+    auto parsed = ModularPolynomial<ModularPrime1>::fromString("1.5x");
+
+    EXPECT_TRUE(std::holds_alternative<SyntaxError>(parsed));
+}
+
+TEST(ModularPolynomialTest, can_evaluate)
+{
+    auto p = std::get<ModularPolynomial<ModularPrime1>>(ModularPolynomial<ModularPrime1>::fromString("3x^2 - 5"));
+
+    EXPECT_EQ(p.evaluate(0, 4, 0, 0).value(), 43u);
+    EXPECT_EQ(p.evaluate(0, 1, 0, 0).signedValue(), -2);
+}
+
+TEST(ModularPolynomialTest, integral_and_derivative_are_inverse)
+{
+    auto p = std::get<ModularPolynomial<ModularPrime1>>(ModularPolynomial<ModularPrime1>::fromString("3x^2 - 5xy + 7"));
+
+    EXPECT_EQ(p.integral(1).derivative(1), p);
+}
+
+TEST(ModularPolynomialTest, throws_when_converting_fractional_polynomial)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("0.5x"));
+
+    EXPECT_THROW(ModularPolynomial<ModularPrime1>::fromIntegerPolynomial(p), std::invalid_argument);
+}
+
+TEST(ModularPolynomialTest, product_matches_floating_point_when_exact)
+{
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("x - 2y + 3z"));
+    Polynomial b = std::get<Polynomial>(Polynomial::fromString("w^3 - x + 4"));
+    Polynomial expected = a.pow(6) * b.pow(3);
+
+    auto ma = ModularPolynomial<ModularPrime1>::fromIntegerPolynomial(a);
+    auto mb = ModularPolynomial<ModularPrime1>::fromIntegerPolynomial(b);
+    auto product = ma.pow(6) * mb.pow(3);
+
+    EXPECT_EQ(Polynomial::fromModularImages(product), expected);
+}
+
+TEST(ModularPolynomialTest, can_reconstruct_coefficients_beyond_one_modulus)
+{
+    // старший коэффициент (3x + 1)^40 равен 3^40 > 2^63 и не восстанавливается по одному модулю
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("3x + 1"));
+    auto p1 = ModularPolynomial<ModularPrime1>::fromIntegerPolynomial(p).pow(40);
+    auto p2 = ModularPolynomial<ModularPrime2>::fromIntegerPolynomial(p).pow(40);
+    auto p3 = ModularPolynomial<ModularPrime3>::fromIntegerPolynomial(p).pow(40);
+
+    Polynomial single = Polynomial::fromModularImages(p1);
+    Polynomial exact = Polynomial::fromModularImages(p1, p2, p3);
+
+    EXPECT_NE(single, exact);
+    EXPECT_DOUBLE_EQ(exact.evaluate(0, 1, 0, 0), std::pow(4.0, 40));
+    EXPECT_DOUBLE_EQ(exact.derivative(1).evaluate(0, 0, 0, 0), 120.0);
+    EXPECT_DOUBLE_EQ(Polynomial::fromModularImages(p1, p2).evaluate(0, 1, 0, 0), std::pow(4.0, 40));
+
+    std::ostringstream out;
+    out << exact;
+    EXPECT_EQ(out.str().substr(0, 13), "1.21577e+19*x");
+}
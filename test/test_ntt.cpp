@@ -0,0 +1,42 @@
+#include <gtest/gtest.h>
+#include "ntt.h"
+
+TEST(NttTest, convolution_of_empty_is_empty)
+{
+    EXPECT_TRUE(Ntt::convolve({}, { 1, 2 }).empty());
+    EXPECT_TRUE(Ntt::convolve({ 1, 2 }, {}).empty());
+}
+
+TEST(NttTest, can_convolve_small_sequences)
+{
+    std::vector<int64_t> res = Ntt::convolve({ 1, 2, 3 }, { 4, 5 });
+    EXPECT_EQ(res, std::vector<int64_t>({ 4, 13, 22, 15 }));
+}
+
+TEST(NttTest, can_convolve_negative_values)
+{
+    std::vector<int64_t> res = Ntt::convolve({ 1, -1 }, { 1, 1 });
+    EXPECT_EQ(res, std::vector<int64_t>({ 1, 0, -1 }));
+}
+
+TEST(NttTest, convolution_is_exact_for_large_values)
+{
+    const int64_t big = int64_t(1) << 26;
+    std::vector<int64_t> res = Ntt::convolve({ big, -big }, { big, big });
+    EXPECT_EQ(res, std::vector<int64_t>({ big * big, 0, -big * big }));
+}
+
+TEST(NttTest, matches_naive_convolution)
+{
+    std::vector<int64_t> a(300);
+    std::vector<int64_t> b(517);
+    for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<int64_t>(i * 7919 % 2001) - 1000;
+    for (size_t i = 0; i < b.size(); ++i) b[i] = static_cast<int64_t>(i * 104729 % 3001) - 1500;
+
+    std::vector<int64_t> expected(a.size() + b.size() - 1, 0);
+    for (size_t i = 0; i < a.size(); ++i)
+        for (size_t j = 0; j < b.size(); ++j)
+            expected[i + j] += a[i] * b[j];
+
+    EXPECT_EQ(Ntt::convolve(a, b), expected);
+}
\ No newline at end of file
@@ -268,4 +268,534 @@ TEST(PolynomialTest, can_evaluate_polynomial_correctly)
         Polynomial p = std::get<Polynomial>(result);
         EXPECT_DOUBLE_EQ(p.evaluate(1, 2, 3, 4), 3.5 * 1.0 * 1.0 - 2.0 * 2.0 + 4.0 * 3.0 * 3.0 * 3.0 - 2.5 * 4.0);
     }
-}
\ No newline at end of file
+}
+TEST(PolynomialTest, size_returns_number_of_monomials)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("3w^2 + 2x + z"));
+    EXPECT_EQ(p.size(), 3);
+    EXPECT_EQ(Polynomial().size(), 0);
+}
+
+TEST(PolynomialTest, sum_keeps_monomials_sorted)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("w^3 + x^2 + z"));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString("w^2 + y + 1"));
+    std::ostringstream oss;
+    oss << p1 + p2;
+    EXPECT_EQ(oss.str(), "1*w^3+1*w^2+1*x^2+1*y+1*z+1");
+}
+
+TEST(PolynomialTest, multiplication_combines_like_terms)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("x + y"));
+    Polynomial p2 = p1 * p1;
+    Polynomial p4 = p2 * p2;
+
+    EXPECT_EQ(p4, std::get<Polynomial>(Polynomial::fromString("x^4 + 4x^3y + 6x^2y^2 + 4xy^3 + y^4")));
+}
+
+TEST(PolynomialTest, multiplication_drops_cancelled_terms)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("x - y"));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString("x + y"));
+
+    EXPECT_EQ(p1 * p2, std::get<Polynomial>(Polynomial::fromString("x^2 - y^2")));
+    EXPECT_EQ(p2 * p1, std::get<Polynomial>(Polynomial::fromString("x^2 - y^2")));
+}
+
+TEST(PolynomialTest, can_multiply_dense_polynomials)
+{
+    // (1 + t + ... + t^4)^2 = 1 + 2t + 3t^2 + 4t^3 + 5t^4 + 4t^5 + 3t^6 + 2t^7 + t^8 по каждой переменной
+    const int squareCoefficients[9] = { 1, 2, 3, 4, 5, 4, 3, 2, 1 };
+    std::string box;
+    std::string square;
+    for (int w = 0; w <= 8; ++w)
+        for (int x = 0; x <= 8; ++x)
+            for (int y = 0; y <= 8; ++y)
+                for (int z = 0; z <= 8; ++z)
+                {
+                    std::string powers = "w" + std::to_string(w) + "x" + std::to_string(x) + "y" + std::to_string(y) + "z" + std::to_string(z);
+                    if (w <= 4 && x <= 4 && y <= 4 && z <= 4) box += "+" + powers;
+                    int coefficient = squareCoefficients[w] * squareCoefficients[x] * squareCoefficients[y] * squareCoefficients[z];
+                    square += "+" + std::to_string(coefficient) + powers;
+                }
+
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString(box));
+    EXPECT_EQ(p * p, std::get<Polynomial>(Polynomial::fromString(square)));
+}
+
+TEST(PolynomialTest, can_multiply_by_hash_accumulation)
+{
+    // Дробные коэффициенты исключают плотное умножение, а произведений (625^2) намного больше,
+    // чем различных степеней (9^4), поэтому они накапливаются в хеш-таблице
+    const int squareCoefficients[9] = { 1, 2, 3, 4, 5, 4, 3, 2, 1 };
+    std::string box;
+    std::string square;
+    for (int w = 0; w <= 8; ++w)
+        for (int x = 0; x <= 8; ++x)
+            for (int y = 0; y <= 8; ++y)
+                for (int z = 0; z <= 8; ++z)
+                {
+                    std::string powers = "w" + std::to_string(w) + "x" + std::to_string(x) + "y" + std::to_string(y) + "z" + std::to_string(z);
+                    if (w <= 4 && x <= 4 && y <= 4 && z <= 4) box += "+0.5" + powers;
+                    int coefficient = squareCoefficients[w] * squareCoefficients[x] * squareCoefficients[y] * squareCoefficients[z];
+                    square += "+" + std::to_string(coefficient * 0.25) + powers;
+                }
+
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString(box));
+    Polynomial q = p * 1.0;
+    Polynomial expected = std::get<Polynomial>(Polynomial::fromString(square));
+
+    EXPECT_EQ(p.multiplicationStrategy(q), MultiplicationStrategy::Hash);
+    EXPECT_EQ(p * q, expected);
+    EXPECT_EQ(p.square(), expected);
+}
+
+TEST(PolynomialTest, reports_multiplication_strategy)
+{
+    Polynomial monomial = std::get<Polynomial>(Polynomial::fromString("3x^2"));
+    Polynomial shortSparse = std::get<Polynomial>(Polynomial::fromString("x^100 + y^200 + 1"));
+    Polynomial dense = std::get<Polynomial>(Polynomial::fromString("x^3 + x^2 + x + 1")).pow(5);
+
+    EXPECT_EQ(shortSparse.multiplicationStrategy(monomial), MultiplicationStrategy::Monomial);
+    EXPECT_EQ(shortSparse.multiplicationStrategy(shortSparse), MultiplicationStrategy::Heap);
+    EXPECT_EQ(dense.multiplicationStrategy(dense), MultiplicationStrategy::Dense);
+    EXPECT_STREQ(multiplicationStrategyName(MultiplicationStrategy::Hash), "hash");
+}
+
+TEST(PolynomialTest, parallel_multiplication_matches_sequential)
+{
+    std::string s1;
+    std::string s2;
+    for (int i = 0; i < 700; ++i)
+    {
+        s1 += "+" + std::to_string(i % 7 + 1) + "w" + std::to_string(i % 13) + "x" + std::to_string(i * 31 % 997) + "y" + std::to_string(i % 5);
+        s2 += "-" + std::to_string(i % 3 + 1) + "x" + std::to_string(i * 17 % 1009) + "y" + std::to_string(i % 11) + "z" + std::to_string(i);
+    }
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString(s1));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString(s2));
+
+    Polynomial::setMultiplicationThreads(1);
+    Polynomial sequential = p1 * p2;
+    Polynomial::setMultiplicationThreads(4);
+    Polynomial parallel = p1 * p2;
+    Polynomial::setMultiplicationThreads(1);
+
+    EXPECT_EQ(Polynomial::multiplicationThreads(), 1);
+    EXPECT_EQ(parallel, sequential);
+}
+
+TEST(PolynomialTest, compound_assignment_merges_in_place)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("w^3 + x^2 + z"));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString("w^4 - x^2 + y + 1"));
+    p1 += p2;
+    std::ostringstream oss;
+    oss << p1;
+    EXPECT_EQ(oss.str(), "1*w^4+1*w^3+1*y+1*z+1");
+    p1 -= p2;
+    EXPECT_EQ(p1, std::get<Polynomial>(Polynomial::fromString("w^3 + x^2 + z")));
+}
+
+TEST(PolynomialTest, self_compound_assignment_is_correct)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("2w + 3x"));
+    p += p;
+    EXPECT_EQ(p, std::get<Polynomial>(Polynomial::fromString("4w + 6x")));
+    p -= p;
+    EXPECT_EQ(p.size(), 0);
+}
+
+TEST(PolynomialTest, rvalue_operators_match_copying_operators)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("w^2 + 2x - 3"));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString("x^2 - 2x + 5"));
+    Polynomial sum = p1 + p2;
+    Polynomial difference = p1 - p2;
+    Polynomial negation = -p1;
+
+    EXPECT_EQ(Polynomial(p1) + p2, sum);
+    EXPECT_EQ(p1 + Polynomial(p2), sum);
+    EXPECT_EQ(Polynomial(p1) + Polynomial(p2), sum);
+    EXPECT_EQ(Polynomial(p1) - p2, difference);
+    EXPECT_EQ(p1 - Polynomial(p2), difference);
+    EXPECT_EQ(Polynomial(p1) - Polynomial(p2), difference);
+    EXPECT_EQ(-Polynomial(p1), negation);
+}
+
+TEST(PolynomialTest, multiplication_by_zero_in_place_gives_zero)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w^2 + 2x - 3"));
+    p *= 0.0;
+    EXPECT_EQ(p.size(), 0);
+}
+
+TEST(PolynomialTest, linear_combination_matches_chained_sum)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("w^2 + 2x - 3"));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString("x^2 - 2x + 5"));
+    Polynomial p3 = std::get<Polynomial>(Polynomial::fromString("y^3 + w^2"));
+    Polynomial p4 = std::get<Polynomial>(Polynomial::fromString("z - 1"));
+    Polynomial combination = Polynomial::linearCombination({ { 1.0, p1 }, { 1.0, p2 }, { -1.0, p3 }, { 4.0, p4 } });
+    EXPECT_EQ(combination, p1 + p2 - p3 + 4.0 * p4);
+}
+
+TEST(PolynomialTest, linear_combination_drops_cancelled_terms)
+{
+    Polynomial p1 = std::get<Polynomial>(Polynomial::fromString("w^2 + 2x"));
+    Polynomial p2 = std::get<Polynomial>(Polynomial::fromString("x + 1"));
+    Polynomial p3(1.0);
+    Polynomial combination = Polynomial::linearCombination({ { 1.0, p1 }, { -2.0, p2 }, { 2.0, p3 } });
+    EXPECT_EQ(combination, std::get<Polynomial>(Polynomial::fromString("w^2")));
+    EXPECT_EQ(Polynomial::linearCombination({}).size(), 0);
+}
+
+TEST(PolynomialTest, batch_evaluation_matches_evaluate)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("3.5w^5x - 2x^2y^7 + 4y^3z^12 - 2.5z + 7"));
+    std::vector<double> w, x, y, z;
+    for (int i = 0; i < 37; ++i)
+    {
+        w.push_back(0.1 * i - 1.5);
+        x.push_back(1.0 - 0.05 * i);
+        y.push_back(0.03 * i);
+        z.push_back(-0.02 * i + 0.7);
+    }
+
+    std::vector<double> values = p.evaluateBatch(w, x, y, z);
+    ASSERT_EQ(values.size(), w.size());
+    for (size_t i = 0; i < w.size(); ++i)
+    {
+        double expected = p.evaluate(w[i], x[i], y[i], z[i]);
+        EXPECT_NEAR(values[i], expected, 1e-12 * (1.0 + std::abs(expected)));
+    }
+}
+
+TEST(PolynomialTest, batch_evaluation_throws_on_different_sizes)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w + x"));
+    std::vector<double> a(3, 1.0), b(2, 1.0);
+    EXPECT_ANY_THROW(p.evaluateBatch(a, a, b, a));
+}
+
+TEST(PolynomialTest, evaluation_is_correct_after_modification)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w^3x^2 + 2w^3 - x^4y + 3y^2z^5 - 1"));
+    Polynomial q = std::get<Polynomial>(Polynomial::fromString("w^3 + z"));
+    EXPECT_DOUBLE_EQ(p.evaluate(2, 3, -1, 0.5), 72.0 + 16.0 + 81.0 + 3.0 / 32.0 - 1.0);
+
+    Polynomial copy = p;
+    copy += q;
+    EXPECT_DOUBLE_EQ(copy.evaluate(2, 3, -1, 0.5), 72.0 + 24.0 + 81.0 + 3.0 / 32.0 - 0.5);
+    EXPECT_DOUBLE_EQ(p.evaluate(2, 3, -1, 0.5), 72.0 + 16.0 + 81.0 + 3.0 / 32.0 - 1.0);
+
+    p *= 2.0;
+    EXPECT_DOUBLE_EQ(p.evaluate(2, 3, -1, 0.5), 2.0 * (72.0 + 16.0 + 81.0 + 3.0 / 32.0 - 1.0));
+    p = q;
+    EXPECT_DOUBLE_EQ(p.evaluate(2, 3, -1, 0.5), 8.5);
+}
+
+TEST(PolynomialTest, copies_made_before_evaluation_evaluate_independently)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w^3x^2 + 2w^3 - x^4y + 3y^2z^5 - 1"));
+    Polynomial copy = p;
+    Polynomial assigned;
+    assigned = p;
+
+    EXPECT_DOUBLE_EQ(copy.evaluate(2, 3, -1, 0.5), 72.0 + 16.0 + 81.0 + 3.0 / 32.0 - 1.0);
+    EXPECT_DOUBLE_EQ(p.evaluate(1, 1, 1, 1), 4.0);
+    EXPECT_DOUBLE_EQ(assigned.evaluate(2, 3, -1, 0.5), 72.0 + 16.0 + 81.0 + 3.0 / 32.0 - 1.0);
+
+    Polynomial late = p; // копия после вычисления разделяет построенную схему
+    EXPECT_DOUBLE_EQ(late.evaluate(2, 3, -1, 0.5), 72.0 + 16.0 + 81.0 + 3.0 / 32.0 - 1.0);
+}
+
+TEST(PolynomialTest, square_matches_multiplication)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("3w^2x - 2xy^3 + 0.5z - y + 7"));
+    EXPECT_EQ(p.square(), p * p);
+}
+
+TEST(PolynomialTest, power_matches_repeated_multiplication)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w - 2x + y^2 + 1"));
+    Polynomial expected(1.0);
+    for (unsigned long k = 0; k <= 7; ++k)
+    {
+        EXPECT_EQ(p.pow(k), expected);
+        expected = expected * p;
+    }
+}
+
+TEST(PolynomialTest, power_of_monomial_multiplies_degrees)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("-2w^3xy^2z^5"));
+    EXPECT_EQ(p.pow(3), std::get<Polynomial>(Polynomial::fromString("-8w^9x^3y^6z^15")));
+}
+
+TEST(PolynomialTest, error_on_power_overflow)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("x^300 + 1"));
+    EXPECT_ANY_THROW(p.pow(300));
+}
+
+TEST(PolynomialTest, multiplication_by_constant_polynomial_scales)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w^2 + 2x - 3"));
+    EXPECT_EQ(Polynomial(2.0) * p, std::get<Polynomial>(Polynomial::fromString("2w^2 + 4x - 6")));
+    EXPECT_EQ(p * Polynomial(0.0), Polynomial());
+}
+
+TEST(PolynomialTest, multiplication_by_monomial_shifts_degrees)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("w^2 + 2x - 3"));
+    Polynomial m = std::get<Polynomial>(Polynomial::fromString("-xz^2"));
+    EXPECT_EQ(p * m, std::get<Polynomial>(Polynomial::fromString("-w^2xz^2 - 2x^2z^2 + 3xz^2")));
+}
+
+TEST(PolynomialTest, gradient_matches_partial_derivatives)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("3w^2x^4 - 2xy^3z + 5yz^2 + w - 7"));
+    std::array<Polynomial, 4> gradient = p.gradient();
+    EXPECT_EQ(gradient[0], p.derivativeW());
+    EXPECT_EQ(gradient[1], p.derivativeX());
+    EXPECT_EQ(gradient[2], p.derivativeY());
+    EXPECT_EQ(gradient[3], p.derivativeZ());
+}
+
+TEST(PolynomialTest, can_differentiate_and_integrate_in_place)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("3w^2x^4 - 2xy^3z + 5yz^2 + w - 7"));
+    Polynomial q = p;
+    q.differentiate(1);
+    EXPECT_EQ(q, p.derivativeX());
+    q = p;
+    q.integrate(3);
+    EXPECT_EQ(q, p.integralZ());
+    EXPECT_ANY_THROW(q.differentiate(4));
+}
+
+TEST(PolynomialTest, failed_integration_keeps_polynomial)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("2x^65535 + y"));
+    Polynomial q = p;
+    EXPECT_ANY_THROW(q.integrate(1));
+    EXPECT_EQ(q, p);
+}
+
+TEST(PolynomialTest, can_parse_constant_followed_by_minus)
+{
+    auto result = Polynomial::fromString("x + 7 - y");
+    ASSERT_TRUE(std::holds_alternative<Polynomial>(result));
+    EXPECT_EQ(std::get<Polynomial>(result), std::get<Polynomial>(Polynomial::fromString("x - y + 7")));
+}
+
+TEST(PolynomialTest, can_parse_unordered_monomials)
+{
+    auto result = Polynomial::fromString("4 + z - 2y^3 + x w^2 + 5w^3");
+    ASSERT_TRUE(std::holds_alternative<Polynomial>(result));
+    EXPECT_EQ(std::get<Polynomial>(result), std::get<Polynomial>(Polynomial::fromString("5w^3 + w^2x - 2y^3 + z + 4")));
+}
+
+TEST(PolynomialTest, error_on_repeated_monomial)
+{
+    auto result = Polynomial::fromString("2xy + 3 - yx");
+    ASSERT_TRUE(std::holds_alternative<SyntaxError>(result));
+    SyntaxError err = std::get<SyntaxError>(result);
+    EXPECT_EQ(err.message, "A polynomial must contain no more than one monomial of each degree.");
+    EXPECT_EQ(err.pos, 12u);
+}
+
+TEST(PolynomialTest, error_on_monomials_without_sign_between_them)
+{
+    const std::pair<const char*, size_t> cases[] = { { "2 3x", 2 }, { "x2 3", 3 }, { "1 2", 2 } };
+    for (const auto& [str, pos] : cases)
+    {
+        auto result = Polynomial::fromString(str);
+        ASSERT_TRUE(std::holds_alternative<SyntaxError>(result)) << str;
+        SyntaxError err = std::get<SyntaxError>(result);
+        EXPECT_EQ(err.message, "Expected '+' or '-' between monomials.") << str;
+        EXPECT_EQ(err.pos, pos) << str;
+    }
+}
+
+TEST(PolynomialTest, append_to_matches_ostream)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("-2.5w^2x^10 + 3xz^12345 - 0.0000001y + 1234567"));
+    std::ostringstream oss;
+    oss << p;
+    std::string text = "p = ";
+    p.appendTo(text);
+    EXPECT_EQ(text, "p = " + oss.str());
+    EXPECT_EQ(oss.str(), "-2.5*w^2*x^10+3*x*z^12345-1e-07*y+1.23457e+06");
+}
+
+TEST(PolynomialTest, append_to_cuts_long_text_on_monomial_boundary)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("2w^2 + 3x + 4y^2"));
+    std::string text;
+    p.appendTo(text, 15);
+    EXPECT_EQ(text, "2*w^2+3*x+4*y^2");
+    text.clear();
+    p.appendTo(text, 14);
+    EXPECT_EQ(text, "2*w^2+3*x...");
+    text.clear();
+    p.appendTo(text, 10);
+    EXPECT_EQ(text, "2*w^2...");
+}
+
+TEST(PolynomialTest, to_chars_reports_small_buffer)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("2w^2 + 3x + 4"));
+    char buffer[16];
+    std::to_chars_result result = p.toChars(buffer, buffer + sizeof(buffer));
+    ASSERT_EQ(result.ec, std::errc());
+    EXPECT_EQ(std::string(buffer, result.ptr), "2*w^2+3*x+4");
+    result = p.toChars(buffer, buffer + 5);
+    EXPECT_EQ(result.ec, std::errc::value_too_large);
+}
+
+TEST(PolynomialTest, can_use_eight_variables_with_small_degrees)
+{
+    using Polynomial8 = BasicPolynomial<8, 8>;
+    auto result = Polynomial8::fromString("2s^3t + uv^2 - 3z + 1");
+    ASSERT_TRUE(std::holds_alternative<Polynomial8>(result));
+    Polynomial8 p = std::get<Polynomial8>(result);
+    EXPECT_DOUBLE_EQ(p.evaluate(1, 2, 3, 4, 5, 6, 7, 8), 4.0 + 48.0 - 24.0 + 1.0);
+
+    Polynomial8 square = p * p;
+    EXPECT_EQ(square, p.square());
+    EXPECT_DOUBLE_EQ(square.evaluate(1, 2, 3, 4, 5, 6, 7, 8), 29.0 * 29.0);
+    EXPECT_EQ(p.gradient()[1], std::get<Polynomial8>(Polynomial8::fromString("2s^3")));
+
+    std::ostringstream oss;
+    oss << p;
+    EXPECT_EQ(oss.str(), "2*s^3*t+1*u*v^2-3*z+1");
+
+    Polynomial8 high = std::get<Polynomial8>(Polynomial8::fromString("s^200 + 1"));
+    EXPECT_ANY_THROW(high * high);
+    EXPECT_TRUE(std::holds_alternative<SyntaxError>(Polynomial8::fromString("s^256")));
+}
+
+TEST(PolynomialTest, detects_exponent_overflow_in_every_field)
+{
+    using Polynomial8 = BasicPolynomial<8, 8>;
+    Polynomial8 top = std::get<Polynomial8>(Polynomial8::fromString("s^128 + z^128 + 1"));
+    Polynomial8 almostTop = std::get<Polynomial8>(Polynomial8::fromString("s^127 + z^127 + 1"));
+    Polynomial8 middle = std::get<Polynomial8>(Polynomial8::fromString("v^255 + 1"));
+
+    EXPECT_ANY_THROW(top * top);
+    EXPECT_NO_THROW(top * almostTop);
+    EXPECT_EQ((top * almostTop).evaluate(1, 1, 1, 1, 1, 1, 1, 1), 9.0);
+    EXPECT_ANY_THROW(middle * middle);
+    EXPECT_ANY_THROW(middle.integral(3));
+    EXPECT_NO_THROW(middle.integral(2));
+
+    Polynomial8 monomial = std::get<Polynomial8>(Polynomial8::fromString("3s^2t^3z"));
+    EXPECT_EQ(monomial.pow(5), std::get<Polynomial8>(Polynomial8::fromString("243s^10t^15z^5")));
+    EXPECT_ANY_THROW(monomial.pow(86));
+}
+
+TEST(PolynomialTest, can_use_two_variables_with_large_degrees)
+{
+    using Polynomial2 = BasicPolynomial<2, 32>;
+    Polynomial2 p = std::get<Polynomial2>(Polynomial2::fromString("y^100000z + 3z^70000"));
+    Polynomial2 q = std::get<Polynomial2>(Polynomial2::fromString("y^1000000 - z"));
+    EXPECT_EQ(p * q, std::get<Polynomial2>(Polynomial2::fromString(
+        "y^1100000z + 3y^1000000z^70000 - y^100000z^2 - 3z^70001")));
+    EXPECT_EQ(q.pow(3).derivative(1), std::get<Polynomial2>(Polynomial2::fromString(
+        "-3y^2000000 + 6y^1000000z - 3z^2")));
+
+    auto result = Polynomial2::fromString("y^4294967296");
+    ASSERT_TRUE(std::holds_alternative<SyntaxError>(result));
+    EXPECT_EQ(std::get<SyntaxError>(result).message, "Too big power! Maximum supported power is 4294967295");
+}
+
+TEST(PolynomialTest, truncated_multiplication_matches_truncated_product)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("1 + 2x - y^2 + 0.5xz^3 + w^4 - 3x^2y^2z"));
+    Polynomial q = std::get<Polynomial>(Polynomial::fromString("3 - x + wy - 2z^2 + x^3y + 0.25w^2x^2z"));
+
+    for (uint64_t degree = 0; degree <= 10; ++degree)
+    {
+        EXPECT_EQ(p.mulTruncated(q, degree), (p * q).truncated(degree));
+        EXPECT_EQ(p.mulTruncated(p, degree), p.square().truncated(degree));
+    }
+    EXPECT_EQ(p.truncated(2), std::get<Polynomial>(Polynomial::fromString("1 + 2x - y^2")));
+    EXPECT_EQ(p.mulTruncated(Polynomial(), 5), Polynomial());
+}
+
+TEST(PolynomialTest, truncated_power_matches_truncated_power)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("1 + x + 0.5y^2 - wz"));
+    Polynomial shifted = std::get<Polynomial>(Polynomial::fromString("x + y^2"));
+
+    EXPECT_EQ(p.powTruncated(0, 0), Polynomial(1.0));
+    EXPECT_EQ(p.powTruncated(12, 4), p.pow(12).truncated(4));
+    EXPECT_EQ(p.powTruncated(7, 100), p.pow(7));
+    EXPECT_EQ(shifted.powTruncated(5, 7), shifted.pow(5).truncated(7));
+    EXPECT_EQ(shifted.powTruncated(5, 4), Polynomial());
+}
+
+TEST(PolynomialTest, truncated_multiplication_detects_overflow_above_max_degree)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("x^40000 + 1"));
+    Polynomial q = std::get<Polynomial>(Polynomial::fromString("x^30000 + y"));
+
+    EXPECT_ANY_THROW(p.mulTruncated(q, 100000));
+    EXPECT_EQ(p.mulTruncated(q, 60000), std::get<Polynomial>(Polynomial::fromString("x^40000y + x^30000 + y")));
+}
+
+TEST(PolynomialTest, switches_to_dense_form_when_box_is_filled)
+{
+    Polynomial box = std::get<Polynomial>(Polynomial::fromString("1 + x + y + xy"))
+        * std::get<Polynomial>(Polynomial::fromString("1 + z + w + wz"));
+    Polynomial sparse = std::get<Polynomial>(Polynomial::fromString("w^5 + x^5 + y^5 + z^5 + 1"));
+
+    EXPECT_TRUE(box.isDense());
+    EXPECT_EQ(box.size(), 16u);
+    EXPECT_FALSE(sparse.isDense());
+    EXPECT_FALSE(std::get<Polynomial>(Polynomial::fromString("x + y")).isDense());
+    EXPECT_TRUE(box.pow(3).isDense());
+}
+
+TEST(PolynomialTest, dense_form_gives_same_results_as_sparse)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("1 + 2x - y + 3xy"))
+        * std::get<Polynomial>(Polynomial::fromString("1 - z + w + 0.5wz"));
+    Polynomial q = std::get<Polynomial>(Polynomial::fromString("w^2 - 3xz + 5"));
+    // сумма с разреженным полиномом остается разреженной
+    Polynomial far = std::get<Polynomial>(Polynomial::fromString("x^10"));
+    Polynomial text = std::get<Polynomial>(Polynomial::fromString(
+        "1.5wxyz + 3wxy - 3xyz + 3xy + wxz + 2wx - 2xz + 2x - 0.5wyz - wy + yz - y + 0.5wz + w - z + 1")) + far - far;
+    ASSERT_TRUE(p.isDense());
+    ASSERT_FALSE(text.isDense());
+
+    std::ostringstream dense, parsed;
+    dense << p;
+    parsed << text;
+    EXPECT_EQ(dense.str(), parsed.str());
+    EXPECT_EQ(p, text);
+    EXPECT_EQ(p + q, text + q);
+    EXPECT_EQ(q - p, q - text);
+    EXPECT_EQ(p * q, text * q);
+    EXPECT_EQ(p.pow(3), text.pow(3));
+    EXPECT_EQ(p.derivative(1), text.derivative(1));
+    EXPECT_EQ(p.integral(3), text.integral(3));
+    EXPECT_DOUBLE_EQ(p.evaluate(0.5, -2, 3, 0.25), text.evaluate(0.5, -2, 3, 0.25));
+    EXPECT_EQ(p.mulTruncated(q, 3), (text * q).truncated(3));
+}
+
+TEST(PolynomialTest, returns_to_sparse_form_after_cancellation)
+{
+    Polynomial p = std::get<Polynomial>(Polynomial::fromString("1 + x + y + xy"))
+        * std::get<Polynomial>(Polynomial::fromString("1 + z + w + wz"));
+    Polynomial q = p - Polynomial(1.0);
+    ASSERT_TRUE(p.isDense());
+
+    p -= q;
+
+    EXPECT_FALSE(p.isDense());
+    EXPECT_EQ(p, Polynomial(1.0));
+    EXPECT_EQ(p.size(), 1u);
+}
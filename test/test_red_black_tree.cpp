@@ -1,4 +1,6 @@
 ﻿#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory_resource>
 #include <string>
 #include <vector>
 #include <random>
@@ -132,6 +134,21 @@ TEST(RedBlackTreeTest, can_convert_to_vector)
     }
 }
 
+TEST(RedBlackTreeTest, allocates_nodes_from_given_resource)
+{
+    std::byte buffer[16 * 1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+    RedBlackTree<int, int> tree(&arena);
+
+    for (int i = 0; i < 100; ++i) tree.insert(i, i * i);
+    for (int i = 0; i < 100; i += 2) EXPECT_TRUE(tree.erase(i));
+
+    EXPECT_EQ(tree.resource(), &arena);
+    EXPECT_EQ(tree.size(), 50);
+    EXPECT_EQ(tree.find(7), 49);
+    EXPECT_TRUE(tree.isValidTree());
+}
+
 //TEST(RedBlackTreeTest, tree_stress_test)
 //{
 //    RedBlackTree<int, int> mTree;
@@ -0,0 +1,127 @@
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <memory_resource>
+#include "small_vector.h"
+
+TEST(SmallVectorTest, can_create_empty)
+{
+    SmallVector<int, 4> v;
+    EXPECT_EQ(v.size(), 0);
+    EXPECT_TRUE(v.empty());
+    EXPECT_TRUE(v.isInline());
+}
+
+TEST(SmallVectorTest, keeps_few_elements_inline)
+{
+    SmallVector<int, 4> v;
+    for (int i = 0; i < 4; ++i)
+    {
+        v.push_back(i);
+    }
+
+    EXPECT_TRUE(v.isInline());
+    EXPECT_EQ(v.size(), 4);
+    EXPECT_EQ(v[3], 3);
+}
+
+TEST(SmallVectorTest, moves_to_heap_when_grows)
+{
+    SmallVector<int, 2> v;
+    for (int i = 0; i < 100; ++i)
+    {
+        v.push_back(i);
+    }
+
+    EXPECT_FALSE(v.isInline());
+    EXPECT_EQ(v.size(), 100);
+    for (int i = 0; i < 100; ++i)
+    {
+        EXPECT_EQ(v[i], i);
+    }
+}
+
+TEST(SmallVectorTest, can_copy_and_move)
+{
+    SmallVector<int, 2> small;
+    small.push_back(1);
+    SmallVector<int, 2> big;
+    for (int i = 0; i < 10; ++i)
+    {
+        big.push_back(i);
+    }
+
+    SmallVector<int, 2> smallCopy(small);
+    SmallVector<int, 2> bigCopy(big);
+    EXPECT_EQ(smallCopy, small);
+    EXPECT_EQ(bigCopy, big);
+
+    SmallVector<int, 2> smallMoved(std::move(smallCopy));
+    SmallVector<int, 2> bigMoved(std::move(bigCopy));
+    EXPECT_EQ(smallMoved, small);
+    EXPECT_EQ(bigMoved, big);
+    EXPECT_EQ(bigCopy.size(), 0);
+
+    smallMoved = std::move(bigMoved);
+    EXPECT_EQ(smallMoved, big);
+    bigMoved = small;
+    EXPECT_EQ(bigMoved, small);
+}
+
+TEST(SmallVectorTest, can_insert_and_erase)
+{
+    SmallVector<int, 2> v;
+    v.push_back(1);
+    v.push_back(5);
+    const int middle[] = { 2, 3, 4 };
+    v.insert(v.begin() + 1, middle, middle + 3);
+
+    ASSERT_EQ(v.size(), 5);
+    for (int i = 0; i < 5; ++i)
+    {
+        EXPECT_EQ(v[i], i + 1);
+    }
+
+    v.erase(v.begin(), v.begin() + 2);
+    ASSERT_EQ(v.size(), 3);
+    EXPECT_EQ(v.front(), 3);
+    EXPECT_EQ(v.back(), 5);
+}
+
+TEST(SmallVectorTest, allocates_from_current_memory_resource)
+{
+    std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    MemoryResourceScope scope(&arena);
+    SmallVector<int, 2> v;
+    for (int i = 0; i < 100; ++i)
+    {
+        v.push_back(i);
+    }
+
+    EXPECT_EQ(v.resource(), &arena);
+    EXPECT_GE(reinterpret_cast<std::byte*>(v.data()), buffer);
+    EXPECT_LT(reinterpret_cast<std::byte*>(v.data()), buffer + sizeof(buffer));
+}
+
+TEST(SmallVectorTest, move_between_resources_copies_elements)
+{
+    SmallVector<int, 2> target;
+
+    std::pmr::monotonic_buffer_resource arena;
+    {
+        MemoryResourceScope scope(&arena);
+        SmallVector<int, 2> source;
+        for (int i = 0; i < 10; ++i)
+        {
+            source.push_back(i);
+        }
+
+        target = std::move(source);
+        EXPECT_TRUE(source.empty());
+    }
+
+    EXPECT_EQ(target.resource(), currentMemoryResource());
+    EXPECT_EQ(target.size(), 10);
+    EXPECT_EQ(target[9], 9);
+}
@@ -1,4 +1,7 @@
 #include <gtest/gtest.h>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
 #include "stack.h"
 
 TEST(StackTest, can_create_with_default_constructor)
@@ -157,4 +160,31 @@ TEST(StackTest, test_empty)
     EXPECT_TRUE(stack.empty());
     stack.push(1);
     EXPECT_FALSE(stack.empty());
-}
\ No newline at end of file
+}
+
+TEST(StackTest, allocates_from_given_resource)
+{
+    std::byte buffer[1024];
+    std::pmr::monotonic_buffer_resource arena(buffer, sizeof(buffer), std::pmr::null_memory_resource());
+
+    Stack<int> stack(&arena);
+    for (int i = 0; i < 10; ++i)
+    {
+        stack.push(i);
+    }
+
+    EXPECT_EQ(stack.resource(), &arena);
+    EXPECT_GE(reinterpret_cast<std::byte*>(&stack.top()), buffer);
+    EXPECT_LT(reinterpret_cast<std::byte*>(&stack.top()), buffer + sizeof(buffer));
+}
+
+TEST(StackTest, pop_destroys_element)
+{
+    auto counter = std::make_shared<int>(0);
+    Stack<std::shared_ptr<int>> stack;
+    stack.push(counter);
+    EXPECT_EQ(counter.use_count(), 2);
+
+    stack.pop();
+    EXPECT_EQ(counter.use_count(), 1);
+}
@@ -8,7 +8,7 @@ protected:
     Table table;
 };
 
-using TableTypes = ::testing::Types<LinearArrTable, LinearListTable, OrderedTable, TreeTable, OpenAddressHashTable, SeparateChainingHashTable>;
+using TableTypes = ::testing::Types<LinearArrTable, LinearListTable, OrderedTable, TreeTable, OpenAddressHashTable, SeparateChainingHashTable, SwissHashTable>;
 TYPED_TEST_SUITE(TableTest, TableTypes);
 
 TYPED_TEST(TableTest, defaultTableConstructor)
@@ -55,12 +55,57 @@ TYPED_TEST(TableTest, canFindExsistingPolynomial)
 {
     Polynomial a = std::get<Polynomial>(Polynomial::fromString("12x2-4y"));
     this->table.addPolynomial("Pol1", a);
-    EXPECT_EQ(this->table.findPolynomial("Pol1"), a);
+    ASSERT_NE(this->table.findPolynomial("Pol1"), nullptr);
+    EXPECT_EQ(*this->table.findPolynomial("Pol1"), a);
+}
+
+TYPED_TEST(TableTest, findReturnsSharedPolynomialWithoutCopying)
+{
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("12x2-4y"));
+    this->table.addPolynomial("Pol1", a);
+
+    PolynomialHandle first = this->table.findPolynomial("Pol1");
+    PolynomialHandle second = this->table.findPolynomial("Pol1");
+    EXPECT_EQ(first.get(), second.get());
+
+    this->table.delPolynomial("Pol1");
+    EXPECT_EQ(this->table.findPolynomial("Pol1"), nullptr);
+    EXPECT_EQ(*first, a); // the handle keeps the deleted polynomial alive
+}
+
+TYPED_TEST(TableTest, canFindAndDelByStringViewIntoSourceText)
+{
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("12x2-4y"));
+    this->table.addPolynomial("Pol1", a);
+    this->table.addPolynomial("Pol", a);
+
+    const std::string source = "Pol1 = Pol12 * 3";
+    std::string_view name = std::string_view(source).substr(0, 4); // "Pol1", not null-terminated
+    ASSERT_NE(this->table.findPolynomial(name), nullptr);
+    EXPECT_EQ(*this->table.findPolynomial(name), a);
+    EXPECT_EQ(this->table.findPolynomial(std::string_view(source).substr(7, 5)), nullptr); // "Pol12"
+
+    this->table.delPolynomial(name);
+    EXPECT_EQ(this->table.findPolynomial("Pol1"), nullptr);
+    EXPECT_NE(this->table.findPolynomial("Pol"), nullptr);
+}
+
+TYPED_TEST(TableTest, getPolynomialsReturnsStoredHandles)
+{
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("12x2-4y"));
+    Polynomial b = std::get<Polynomial>(Polynomial::fromString("x + 1"));
+    this->table.addPolynomial("Pol1", a);
+    this->table.addPolynomial("Pol2", b);
+
+    auto records = this->table.getPolynomials();
+    ASSERT_EQ(records.size(), 2);
+    for (const auto& [name, handle] : records)
+        EXPECT_EQ(handle.get(), this->table.findPolynomial(name).get()) << name;
 }
 
 TYPED_TEST(TableTest, cannotFindUnexsistingPolynomial)
 {
-    EXPECT_EQ(this->table.findPolynomial("Pol1"), std::nullopt);
+    EXPECT_EQ(this->table.findPolynomial("Pol1"), nullptr);
 }
 
 TYPED_TEST(TableTest, canDelPresentPolynomial)
@@ -108,6 +153,87 @@ TYPED_TEST(TableTest, nonEmptyTableIsNonEmpty)
 }
 
 
+TYPED_TEST(TableTest, keepsFindingRemainingPolynomialsAfterDeletes)
+{
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("12x2-4y"));
+    for (int i = 0; i < 200; i++)
+        this->table.addPolynomial("p" + std::to_string(i), a);
+    for (int i = 0; i < 200; i += 3)
+        this->table.delPolynomial("p" + std::to_string(i));
+
+    EXPECT_EQ(this->table.size(), 133);
+    for (int i = 0; i < 200; i++)
+        EXPECT_EQ(this->table.findPolynomial("p" + std::to_string(i)) == nullptr, i % 3 == 0) << i;
+}
+
+TEST(OpenAddressHashTable, probeLengthStaysBoundedUnderChurn)
+{
+    OpenAddressHashTable table;
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("x"));
+
+    // 50 live names, 20000 assignments and deletes: without tombstones the table neither grows nor degrades
+    for (int i = 0; i < 20000; i++)
+    {
+        if (i >= 50)
+            table.delPolynomial("t" + std::to_string(i - 50));
+        table.addPolynomial("t" + std::to_string(i), a);
+    }
+
+    EXPECT_EQ(table.size(), 50);
+    EXPECT_LE(table.capacity(), 128);
+    EXPECT_LE(table.maxProbeLength(), 16);
+    for (int i = 19950; i < 20000; i++)
+        EXPECT_NE(table.findPolynomial("t" + std::to_string(i)), nullptr);
+    EXPECT_EQ(table.findPolynomial("t0"), nullptr);
+}
+
+TEST(OpenAddressHashTable, growsBeforeLoadFactorExceedsThreeQuarters)
+{
+    OpenAddressHashTable table;
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("x"));
+
+    for (int i = 0; i < 1000; i++)
+    {
+        table.addPolynomial(std::to_string(i), a);
+        EXPECT_LE(table.size() * 4, table.capacity() * 3);
+    }
+}
+
+TEST(SwissHashTable, canFindManyPolynomials)
+{
+    SwissHashTable table;
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("x"));
+
+    for (int i = 0; i < 20000; i++)
+        table.addPolynomial("s" + std::to_string(i), a);
+
+    EXPECT_EQ(table.size(), 20000);
+    EXPECT_LE(table.size() * 8, table.capacity() * 7);
+    for (int i = 0; i < 20000; i++)
+        EXPECT_NE(table.findPolynomial("s" + std::to_string(i)), nullptr);
+    EXPECT_EQ(table.findPolynomial("s20000"), nullptr);
+    EXPECT_EQ(table.getPolynomials().size(), 20000);
+}
+
+TEST(SwissHashTable, deletedSlotsDoNotGrowTableUnderChurn)
+{
+    SwissHashTable table;
+    Polynomial a = std::get<Polynomial>(Polynomial::fromString("x"));
+
+    for (int i = 0; i < 20000; i++)
+    {
+        if (i >= 50)
+            table.delPolynomial("t" + std::to_string(i - 50));
+        table.addPolynomial("t" + std::to_string(i), a);
+    }
+
+    EXPECT_EQ(table.size(), 50);
+    EXPECT_LE(table.capacity(), 128);
+    for (int i = 19950; i < 20000; i++)
+        EXPECT_NE(table.findPolynomial("t" + std::to_string(i)), nullptr);
+    EXPECT_EQ(table.findPolynomial("t19949"), nullptr);
+}
+
 TEST(Aggregator, defaultAggregatorConstructor)
 {
     Aggregator a;
@@ -118,9 +244,9 @@ TEST(Aggregator, defaultAggregatorConstructor)
 TEST(Aggregator, canSelectCorrectTable)
 {
     Aggregator aggr;
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
 
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < tableNames.size(); i++)
         EXPECT_NO_THROW(aggr.selectTable(tableNames[i]));
 }
 
@@ -135,7 +261,7 @@ TEST(Aggregator, canFindExsistingPolynomialUsingAggregator)
     Aggregator* pAggregator = new Aggregator();
 
     std::vector<Polynomial> pols;
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     int polyCount = 50;
     for (int i = 1; i < polyCount + 1; i++)
     {
@@ -169,15 +295,16 @@ TEST(Aggregator, canFindExsistingPolynomialUsingAggregator)
 
     for (int i = 0; i < polyCount; i++)
     {
-        pAggregator->selectTable(tableNames[i % 6]);
+        pAggregator->selectTable(tableNames[i % tableNames.size()]);
 
-        EXPECT_EQ((pAggregator->findPolynomial(std::to_string(i))).value(), pols[i]);
+        ASSERT_NE(pAggregator->findPolynomial(std::to_string(i)), nullptr);
+        EXPECT_EQ(*pAggregator->findPolynomial(std::to_string(i)), pols[i]);
     }
 }
 
 TEST(Aggregator, cannotFindUnexsistingPolynomialUsingAggregator)
 {
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     Aggregator aggr;
 
     aggr.addPolynomial("fir", std::get<Polynomial>(Polynomial::fromString("x")));
@@ -185,10 +312,10 @@ TEST(Aggregator, cannotFindUnexsistingPolynomialUsingAggregator)
     aggr.addPolynomial("trd", std::get<Polynomial>(Polynomial::fromString("z")));
     aggr.addPolynomial("frt", std::get<Polynomial>(Polynomial::fromString("y")));
 
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < tableNames.size(); i++)
     {
         aggr.selectTable(tableNames[i]);
-        EXPECT_EQ(aggr.findPolynomial("fft"), std::nullopt);
+        EXPECT_EQ(aggr.findPolynomial("fft"), nullptr);
     }
 }
 
@@ -196,7 +323,7 @@ TEST(Aggregator, canAddUnpresentPolynomialUsingAggregator)
 {
     Aggregator aggr;
 
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     int polyCount = 100; // TODO ������� 100
     for (int i = 1; i < polyCount + 1; i++)
     {
@@ -228,6 +355,24 @@ TEST(Aggregator, canAddUnpresentPolynomialUsingAggregator)
     EXPECT_EQ(aggr.size(), sz + 1);
 }
 
+TEST(Aggregator, allTablesShareOneStoredPolynomial)
+{
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
+    Aggregator aggr;
+
+    aggr.addPolynomial("shared", std::get<Polynomial>(Polynomial::fromString("x3y5z4w2 + 7")));
+    aggr.selectTable("liar");
+    PolynomialHandle first = aggr.findPolynomial("shared");
+    ASSERT_NE(first, nullptr);
+
+    for (int i = 0; i < tableNames.size(); i++)
+    {
+        aggr.selectTable(tableNames[i]);
+        EXPECT_EQ(aggr.findPolynomial("shared").get(), first.get());
+    }
+    EXPECT_EQ(first.use_count(), 8); // seven tables and this handle
+}
+
 TEST(Aggregator, cannotAddPresentPolynomialUsingAggregator)
 {
     Aggregator aggr;
@@ -241,7 +386,7 @@ TEST(Aggregator, canDelPresentPolynomialUsingAggregator)
 {
     Aggregator aggr;
 
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     std::vector<std::string> polynomials = { "x3y5z4w2", "xy", "zy", "wyz2", "xy5", "-x4y5", "45+ xy", "78", "234x + 6y", "53xyz", "wx", "w" };
 
     for (int i = 0; i < polynomials.size(); i++)
@@ -256,11 +401,11 @@ TEST(Aggregator, canDelPresentPolynomialUsingAggregator)
 
     for (int i = 3; i < 9; i++)
     {
-        aggr.selectTable(tableNames[i % 6]);
+        aggr.selectTable(tableNames[i % tableNames.size()]);
         aggr.delPolynomial(std::to_string(i));
     }
 
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < tableNames.size(); i++)
     {
         aggr.selectTable(tableNames[i]);
         int newSz = aggr.size();
@@ -273,7 +418,7 @@ TEST(Aggregator, delOfUnpresentPolynomialDoesNothingUsingAggregator)
     Aggregator aggr;
     OpenAddressHashTable tab; // TODO debug, to be deleted
 
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     std::vector<std::string> polynomials = { "x3y5z4w2", "xy", "zy", "wyz2", "xy5", "-x4y5", "45+ xy", "78", "234x + 6y", "53xyz", "wx", "w" };
 
     for (int i = 0; i < polynomials.size(); i++)
@@ -290,7 +435,7 @@ TEST(Aggregator, delOfUnpresentPolynomialDoesNothingUsingAggregator)
 
     for (int i = 453; i < 459; i++)
     {
-        aggr.selectTable(tableNames[i % 6]);
+        aggr.selectTable(tableNames[i % tableNames.size()]);
         tab.delPolynomial(std::to_string(i)); // TODO debug, to be deleted BUG IS HERE
         aggr.delPolynomial(std::to_string(i));
     }
@@ -302,7 +447,7 @@ TEST(Aggregator, canGetSizeWhenEmptyUsingAggregator)
 {
     Aggregator aggr;
 
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     std::vector<std::string> polynomials = { "x3y5z4w2", "xy", "zy", "wyz2", "xy5", "-x4y5", "45+ xy", "78", "234x + 6y", "53xyz", "wx", "w" };
 
     for (int i = 0; i < polynomials.size(); i++)
@@ -310,11 +455,11 @@ TEST(Aggregator, canGetSizeWhenEmptyUsingAggregator)
 
     for (int i = 0; i < polynomials.size(); i++)
     {
-        aggr.selectTable(tableNames[i % 6]);
+        aggr.selectTable(tableNames[i % tableNames.size()]);
         aggr.delPolynomial(std::to_string(i));
     }
 
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < tableNames.size(); i++)
     {
         aggr.selectTable(tableNames[i]);
         EXPECT_EQ(aggr.size(), 0);
@@ -325,7 +470,7 @@ TEST(Aggregator, canGetSizeWhenNonEmptyUsingAggregator)
 {
     Aggregator aggr;
 
-    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha" };
+    std::vector<std::string> tableNames = { "liar" , "lili", "ordr", "tree", "opha", "seha", "swis" };
     std::vector<std::string> polynomials = { "x3y5z4w2", "xy", "zy", "wyz2", "xy5", "-x4y5", "45+ xy", "78", "234x + 6y", "53xyz", "wx", "w" };
 
     int resSize = 6;
@@ -335,11 +480,11 @@ TEST(Aggregator, canGetSizeWhenNonEmptyUsingAggregator)
 
     for (int i = 0; i < polynomials.size() - resSize; i++)
     {
-        aggr.selectTable(tableNames[i % 6]);
+        aggr.selectTable(tableNames[i % tableNames.size()]);
         aggr.delPolynomial(std::to_string(i));
     }
 
-    for (int i = 0; i < 6; i++)
+    for (int i = 0; i < tableNames.size(); i++)
     {
         aggr.selectTable(tableNames[i]);
         EXPECT_EQ(aggr.size(), resSize);
@@ -7,6 +7,7 @@ tokens = [
     "NONE", "FLOAT", "INT", "ID", "X", "Y", "Z", "W",
     "LPAR", "RPAR", "PLUS", "MINUS", "MULT", "CARET", "ASSIGN", "COMMA",
     "CALC", "DERX", "DERY", "DERZ", "DERW", "INTX", "INTY", "INTZ", "INTW",
+    "TRUNCMUL", "TRUNCPOW",
     "INVALID", "ENDOFFILE"
 ]
 